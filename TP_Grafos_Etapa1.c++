@@ -5,7 +5,8 @@
  * Data: 11 de abril de 2025
  * Descrição: Este programa lê arquivos de grafos no formato .dat,
  *            calcula métricas estruturais (grau, densidade, caminho médio, etc.),
- *            aplica o algoritmo de Floyd-Warshall e exporta a visualização.
+ *            aplica o algoritmo de Floyd-Warshall e exporta a visualização
+ *            (lista de arestas, atributos dos nós e um layout por forças).
  */
 
 #include <iostream>
@@ -19,12 +20,23 @@
 #include <limits>
 #include <algorithm>
 #include <iomanip>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
 
 using namespace std;
 
 // Definimos um valor grande para representar "infinito"
 const int INFINITO = 1e9;
 
+// Parâmetros do layout por forças (Fruchterman-Reingold com aproximação de Barnes-Hut)
+const int ITERACOES_LAYOUT = 300;
+const double THETA_BARNES_HUT = 0.8; // Razão tamanho/distância abaixo da qual uma célula é tratada como um único corpo
+
 // Estrutura que representa um nó (vértice) do grafo
 struct No {
     int id;
@@ -89,6 +101,12 @@ void lerArquivo(const string& nomeArquivo, map<int, No>& nos, vector<Aresta>& ar
             stringstream ss(linha);
             ss >> origem >> destino >> custo;
             arestas.push_back({origem, destino, custo, 0, false, false});
+        } else if (linha.substr(0, 3) == "NrE") {
+            string etiqueta;
+            int origem, destino, custo;
+            stringstream ss(linha);
+            ss >> etiqueta >> origem >> destino >> custo;
+            arestas.push_back({origem, destino, custo, 0, false, false});
         }
     }
 
@@ -119,8 +137,302 @@ void lerArquivo(const string& nomeArquivo, map<int, No>& nos, vector<Aresta>& ar
     arquivo.close();
 }
 
-// Função principal que processa o grafo de um arquivo e calcula métricas
-void processarArquivo(const string& nomeArquivo) {
+// Estrutura que representa a posição de um nó no layout
+struct Ponto {
+    double x = 0, y = 0;
+};
+
+// Quadtree usada pela aproximação de Barnes-Hut: cada célula guarda o centro de massa dos
+// pontos que contém, permitindo calcular a repulsão de todos os nós em O(n log n).
+class QuadTree {
+public:
+    // Reconstrói a árvore para o conjunto de pontos atual.
+    void construir(const vector<Ponto>& pontos) {
+        celulas.clear();
+        double min_x = INFINITO, min_y = INFINITO, max_x = -INFINITO, max_y = -INFINITO;
+        for (const auto& p : pontos) {
+            min_x = min(min_x, p.x); min_y = min(min_y, p.y);
+            max_x = max(max_x, p.x); max_y = max(max_y, p.y);
+        }
+        double lado = max(max_x - min_x, max_y - min_y) + 1e-9;
+        celulas.push_back({min_x, min_y, lado});
+        for (size_t i = 0; i < pontos.size(); ++i) inserir(0, pontos, i, 0);
+    }
+
+    // Soma a força de repulsão (k^2 / d) exercida sobre o ponto i por todos os demais.
+    Ponto repulsao(const vector<Ponto>& pontos, int i, double k2) const {
+        Ponto forca;
+        acumular(0, pontos, i, k2, forca);
+        return forca;
+    }
+
+private:
+    struct Celula {
+        double x0, y0, lado;
+        double massa = 0, cx = 0, cy = 0; // Quantidade de pontos e centro de massa
+        int ponto = -1;                   // Índice do ponto, se for folha com um único ponto
+        int filhos[4] = {-1, -1, -1, -1};
+    };
+    vector<Celula> celulas;
+
+    int quadrante(const Celula& c, const Ponto& p) const {
+        double meio = c.lado / 2;
+        return (p.x >= c.x0 + meio ? 1 : 0) + (p.y >= c.y0 + meio ? 2 : 0);
+    }
+
+    int filho(int idx, int q) {
+        if (celulas[idx].filhos[q] == -1) {
+            double meio = celulas[idx].lado / 2;
+            Celula nova{celulas[idx].x0 + (q & 1 ? meio : 0), celulas[idx].y0 + (q & 2 ? meio : 0), meio};
+            celulas.push_back(nova);
+            celulas[idx].filhos[q] = celulas.size() - 1;
+        }
+        return celulas[idx].filhos[q];
+    }
+
+    void inserir(int idx, const vector<Ponto>& pontos, int i, int profundidade) {
+        Celula& c = celulas[idx];
+        c.cx = (c.cx * c.massa + pontos[i].x) / (c.massa + 1);
+        c.cy = (c.cy * c.massa + pontos[i].y) / (c.massa + 1);
+        c.massa += 1;
+        if (c.massa == 1) { c.ponto = i; return; }
+        if (profundidade > 40) return; // Pontos coincidentes: permanecem agregados nesta célula
+        if (c.ponto != -1) {
+            int antigo = c.ponto;
+            celulas[idx].ponto = -1;
+            int q_antigo = quadrante(celulas[idx], pontos[antigo]);
+            inserir(filho(idx, q_antigo), pontos, antigo, profundidade + 1);
+        }
+        int q = quadrante(celulas[idx], pontos[i]);
+        inserir(filho(idx, q), pontos, i, profundidade + 1);
+    }
+
+    void acumular(int idx, const vector<Ponto>& pontos, int i, double k2, Ponto& forca) const {
+        const Celula& c = celulas[idx];
+        if (c.massa == 0 || c.ponto == i) return;
+        double dx = pontos[i].x - c.cx, dy = pontos[i].y - c.cy;
+        double d2 = dx * dx + dy * dy + 1e-9;
+        bool folha = c.filhos[0] == -1 && c.filhos[1] == -1 && c.filhos[2] == -1 && c.filhos[3] == -1;
+        // Uma célula que contém o próprio ponto i nunca é aproximada (i repeliria a si mesmo); só é
+        // tratada como corpo único se for uma folha de pontos coincidentes, descontando i da massa.
+        bool contem_i = pontos[i].x >= c.x0 && pontos[i].x < c.x0 + c.lado && pontos[i].y >= c.y0 && pontos[i].y < c.y0 + c.lado;
+        if (folha || (!contem_i && c.lado * c.lado < THETA_BARNES_HUT * THETA_BARNES_HUT * d2)) {
+            // Força k^2/d na direção (dx, dy)/d, multiplicada pela massa da célula
+            double fator = (c.massa - (contem_i ? 1 : 0)) * k2 / d2;
+            forca.x += dx * fator; forca.y += dy * fator;
+            return;
+        }
+        for (int f : c.filhos) if (f != -1) acumular(f, pontos, i, k2, forca);
+    }
+};
+
+// Threads reaproveitadas entre as iterações do layout: são criadas uma única vez e, a cada chamada de
+// executar(), dividem entre si as tarefas [0, num_tarefas).
+class PoolTrabalhadores {
+public:
+    explicit PoolTrabalhadores(int num_threads) {
+        for (int t = 0; t < num_threads; ++t) threads.emplace_back([this] { executarLaco(); });
+    }
+
+    ~PoolTrabalhadores() {
+        { lock_guard<mutex> trava(mtx); encerrando = true; }
+        cv_lote.notify_all();
+        for (auto& th : threads) th.join();
+    }
+
+    PoolTrabalhadores(const PoolTrabalhadores&) = delete;
+    PoolTrabalhadores& operator=(const PoolTrabalhadores&) = delete;
+
+    // Executa tarefa(i) para todo i em [0, num_tarefas) e retorna quando todas terminarem.
+    void executar(size_t num_tarefas, const function<void(size_t)>& tarefa) {
+        {
+            lock_guard<mutex> trava(mtx);
+            tarefa_atual = &tarefa; total_tarefas = num_tarefas; proxima_tarefa = 0;
+            threads_ocupadas = threads.size(); ++lote;
+        }
+        cv_lote.notify_all();
+        unique_lock<mutex> trava(mtx);
+        cv_fim.wait(trava, [&] { return threads_ocupadas == 0; });
+        tarefa_atual = nullptr;
+    }
+
+private:
+    void executarLaco() {
+        long long lote_visto = 0;
+        while (true) {
+            {
+                unique_lock<mutex> trava(mtx);
+                cv_lote.wait(trava, [&] { return encerrando || lote != lote_visto; });
+                if (encerrando) return;
+                lote_visto = lote;
+            }
+            for (size_t i = proxima_tarefa++; i < total_tarefas; i = proxima_tarefa++) (*tarefa_atual)(i);
+            {
+                lock_guard<mutex> trava(mtx);
+                if (--threads_ocupadas == 0) cv_fim.notify_one();
+            }
+        }
+    }
+
+    vector<thread> threads;
+    mutex mtx;
+    condition_variable cv_lote, cv_fim;
+    const function<void(size_t)>* tarefa_atual = nullptr;
+    size_t total_tarefas = 0;
+    atomic<size_t> proxima_tarefa{0};
+    size_t threads_ocupadas = 0;
+    long long lote = 0;
+    bool encerrando = false;
+};
+
+// Calcula um layout por forças (Fruchterman-Reingold). A repulsão usa a quadtree de Barnes-Hut
+// e é dividida entre as threads do pool, criadas uma única vez; a atração percorre cada aresta uma única vez.
+vector<Ponto> calcularLayoutForcas(int n, const vector<pair<int, int>>& ligacoes) {
+    vector<Ponto> pos(n), deslocamento(n);
+    if (n == 0) return pos;
+    mt19937 gen(42);
+    uniform_real_distribution<double> distrib(0.0, 1.0);
+    for (auto& p : pos) { p.x = distrib(gen); p.y = distrib(gen); }
+
+    double k = sqrt(1.0 / n), k2 = k * k;
+    double temperatura = 0.1;
+    int num_threads = max(1u, thread::hardware_concurrency());
+    int bloco = (n + num_threads - 1) / num_threads;
+    int num_blocos = (n + bloco - 1) / bloco;
+    PoolTrabalhadores pool(min(num_threads, num_blocos));
+    QuadTree arvore;
+    auto calcularRepulsaoBloco = [&](size_t b) {
+        int ini = b * bloco, fim = min(n, ini + bloco);
+        for (int i = ini; i < fim; ++i) deslocamento[i] = arvore.repulsao(pos, i, k2);
+    };
+
+    for (int it = 0; it < ITERACOES_LAYOUT; ++it) {
+        arvore.construir(pos);
+        pool.executar(num_blocos, calcularRepulsaoBloco);
+
+        for (const auto& [u, v] : ligacoes) {
+            double dx = pos[u].x - pos[v].x, dy = pos[u].y - pos[v].y;
+            double d = sqrt(dx * dx + dy * dy) + 1e-9;
+            double fator = d / k; // Atração d^2/k na direção (dx, dy)/d
+            deslocamento[u].x -= dx * fator; deslocamento[u].y -= dy * fator;
+            deslocamento[v].x += dx * fator; deslocamento[v].y += dy * fator;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            double d = sqrt(deslocamento[i].x * deslocamento[i].x + deslocamento[i].y * deslocamento[i].y) + 1e-9;
+            double passo = min(d, temperatura);
+            pos[i].x += deslocamento[i].x / d * passo;
+            pos[i].y += deslocamento[i].y / d * passo;
+        }
+        temperatura *= 0.98;
+    }
+    return pos;
+}
+
+// Exporta o grafo para visualização em Python em dois arquivos colunares (CSV):
+//   <arquivo>.arestas.csv: uma linha por aresta ou arco, sem duplicar as arestas não direcionadas;
+//   <arquivo>.nos.csv: coordenadas do layout pré-calculado e atributos de cada nó.
+void exportarVisualizacao(const string& nomeArquivo, const set<int>& conjunto_nos, const map<int, No>& nos,
+                          const vector<Aresta>& arestas, const map<int, int>& intermediacao) {
+    map<int, int> indice;
+    vector<int> ids(conjunto_nos.begin(), conjunto_nos.end());
+    for (size_t i = 0; i < ids.size(); ++i) indice[ids[i]] = i;
+
+    vector<pair<int, int>> ligacoes;
+    for (const auto& a : arestas) ligacoes.push_back({indice[a.origem], indice[a.destino]});
+    vector<Ponto> pos = calcularLayoutForcas(ids.size(), ligacoes);
+
+    string nomeArestas = nomeArquivo + ".arestas.csv";
+    ofstream saida_arestas(nomeArestas);
+    if (!saida_arestas.is_open()) {
+        cerr << "Erro ao criar arquivo de visualização: " << nomeArestas << endl;
+        return;
+    }
+    saida_arestas << "origem,destino,direcionada,requerida\n";
+    for (const auto& a : arestas) {
+        saida_arestas << a.origem << "," << a.destino << "," << a.direcionada << "," << a.requerido << "\n";
+    }
+    saida_arestas.close();
+
+    string nomeNos = nomeArquivo + ".nos.csv";
+    ofstream saida_nos(nomeNos);
+    if (!saida_nos.is_open()) {
+        cerr << "Erro ao criar arquivo de visualização: " << nomeNos << endl;
+        return;
+    }
+    saida_nos << "id,x,y,demanda,requerido,intermediacao\n";
+    saida_nos << setprecision(6);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        auto no = nos.find(ids[i]);
+        auto inter = intermediacao.find(ids[i]);
+        saida_nos << ids[i] << "," << pos[i].x << "," << pos[i].y << ","
+                  << (no != nos.end() ? no->second.demanda : 0) << ","
+                  << (no != nos.end() && no->second.requerido) << ","
+                  << (inter != intermediacao.end() ? inter->second : 0) << "\n";
+    }
+    saida_nos.close();
+}
+
+// Intermediação pelo algoritmo de Brandes: um Dijkstra por origem (O(V·E log V) no total) e, na volta,
+// o acúmulo das dependências. Para cada nó v, soma sobre os pares (s, t) a fração dos caminhos mínimos
+// de s a t que passam por v (arredondada para inteiro).
+map<int, int> calcularIntermediacaoBrandes(const set<int>& conjunto_nos, const map<int, vector<pair<int, int>>>& adjacencia) {
+    vector<int> ids(conjunto_nos.begin(), conjunto_nos.end());
+    map<int, int> indice;
+    for (size_t i = 0; i < ids.size(); ++i) indice[ids[i]] = i;
+    int n = ids.size();
+    vector<vector<pair<int, int>>> vizinhos(n);
+    for (const auto& [u, lista] : adjacencia) {
+        for (const auto& [v, custo] : lista) vizinhos[indice[u]].push_back({indice[v], custo});
+    }
+
+    vector<double> intermediacao(n, 0.0), sigma(n), dependencia(n);
+    vector<long long> dist(n);
+    vector<vector<int>> antecessores(n);
+    vector<int> ordem; // Nós na ordem em que foram finalizados (distância não decrescente)
+    for (int s = 0; s < n; ++s) {
+        fill(dist.begin(), dist.end(), -1);
+        fill(sigma.begin(), sigma.end(), 0.0);
+        fill(dependencia.begin(), dependencia.end(), 0.0);
+        for (auto& a : antecessores) a.clear();
+        ordem.clear();
+
+        priority_queue<pair<long long, int>, vector<pair<long long, int>>, greater<>> fila;
+        dist[s] = 0; sigma[s] = 1; fila.push({0, s});
+        vector<bool> finalizado(n, false);
+        while (!fila.empty()) {
+            auto [d, u] = fila.top(); fila.pop();
+            if (finalizado[u]) continue;
+            finalizado[u] = true;
+            ordem.push_back(u);
+            for (const auto& [v, custo] : vizinhos[u]) {
+                long long nova = d + custo;
+                if (dist[v] == -1 || nova < dist[v]) {
+                    dist[v] = nova; sigma[v] = sigma[u];
+                    antecessores[v].assign(1, u);
+                    fila.push({nova, v});
+                } else if (nova == dist[v]) {
+                    sigma[v] += sigma[u];
+                    antecessores[v].push_back(u);
+                }
+            }
+        }
+        for (int i = ordem.size() - 1; i >= 0; --i) {
+            int w = ordem[i];
+            for (int v : antecessores[w]) dependencia[v] += sigma[v] / sigma[w] * (1 + dependencia[w]);
+            if (w != s) intermediacao[w] += dependencia[w];
+        }
+    }
+
+    map<int, int> resultado;
+    for (int i = 0; i < n; ++i) resultado[ids[i]] = (int)llround(intermediacao[i]);
+    return resultado;
+}
+
+// Função principal que processa o grafo de um arquivo e calcula métricas.
+// Com somente_visualizacao, pula as métricas (Floyd-Warshall e intermediação por pares, cúbicos no número
+// de nós) e apenas exporta os arquivos de visualização, com a intermediação calculada por Brandes.
+void processarArquivo(const string& nomeArquivo, bool somente_visualizacao) {
     map<int, No> nos;
     vector<Aresta> arestas;
     lerArquivo(nomeArquivo, nos, arestas);
@@ -155,6 +467,12 @@ void processarArquivo(const string& nomeArquivo) {
         if (no.requerido) num_nos_requeridos++;
     }
 
+    if (somente_visualizacao) {
+        exportarVisualizacao(nomeArquivo, conjunto_nos, nos, arestas, calcularIntermediacaoBrandes(conjunto_nos, adjacencia));
+        cout << "Visualizacao exportada (" << conjunto_nos.size() << " nos; metricas nao calculadas, intermediacao por Brandes)." << endl;
+        return;
+    }
+
     // Cálculo da densidade
     int V = conjunto_nos.size();
     int total_conexoes = num_arestas + num_arcos;
@@ -252,38 +570,28 @@ void processarArquivo(const string& nomeArquivo) {
     cout << "12. Diametro: " << diametro << endl;
 
     // Exportar grafo para visualização em Python
-    string nomeSaida = nomeArquivo + ".txt";
-    ofstream saida(nomeSaida);
-    if (!saida.is_open()) {
-        cerr << "Erro ao criar arquivo de visualização: " << nomeSaida << endl;
-        return;
-    }
-
-    saida << "V: ";
-    for (int v : conjunto_nos) {
-        saida << v << " ";
-    }
-    saida << "\nE: ";
-    for (const auto& a : arestas) {
-        // Exporta arestas e arcos como pares
-        saida << "(" << a.origem << "," << a.destino << ") ";
-        if (!a.direcionada) {
-            // Se não for direcionada, adiciona também o inverso para simetria
-            saida << "(" << a.destino << "," << a.origem << ") ";
-        }
-    }
-    saida << endl;
-    saida.close();
+    exportarVisualizacao(nomeArquivo, conjunto_nos, nos, arestas, intermediacao);
 }
 
 
-int main() {
+// Opções: --somente-visualizacao exporta apenas os arquivos de visualização (útil em instâncias grandes);
+//         nomes de arquivos .dat na linha de comando substituem a lista abaixo.
+int main(int argc, char* argv[]) {
     vector<string> arquivos = {
         "BHW6.dat", "BHW2.dat", "BHW3.dat", "BHW4.dat"
     };
 
+    bool somente_visualizacao = false;
+    vector<string> arquivos_linha_comando;
+    for (int i = 1; i < argc; ++i) {
+        string opcao = argv[i];
+        if (opcao == "--somente-visualizacao") somente_visualizacao = true;
+        else arquivos_linha_comando.push_back(opcao);
+    }
+    if (!arquivos_linha_comando.empty()) arquivos = arquivos_linha_comando;
+
     for (const string& nomeArquivo : arquivos) {
-        processarArquivo(nomeArquivo);
+        processarArquivo(nomeArquivo, somente_visualizacao);
     }
 
     return 0;
@@ -23,7 +23,31 @@
 #include <algorithm>
 #include <random>
 #include <set>
+#include <queue>
 #include <numeric>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <atomic>
+#include <array>
+#include <memory>
+#include <cstring>
+#include <cerrno>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <ctime>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 using namespace chrono;
@@ -35,6 +59,215 @@ struct Parametros {
     static inline const int MAX_ITERACOES_ILS = 200;
     static inline const int MAX_ITER_SEM_MELHORA = 50;
     static inline const double TAXA_DESTRUICAO = 0.20; // Percentual de serviços a serem removidos
+    static inline const int MAX_ITERACOES_ILS_WARM_START = 50; // Orçamento do ILS ao reotimizar uma solução anterior
+    static inline const int MAX_NOS_LB_ATRIBUICAO = 600; // Acima disso, o limite de deslocamento usa a relaxação gulosa
+    static inline const int MAX_SERVICOS_DP = 10; // Rotas até esse tamanho são resequenciadas de forma exata (Held-Karp)
+    static inline const int TAMANHO_CACHE_DP = 4096; // Entradas (por thread) do cache de rotas já resolvidas
+    static inline const int ITERACOES_AQUECIMENTO = 5; // Iterações do ILS autorizadas a alocar (só verificado com CONTAR_ALOCACOES)
+    static inline const int MIN_SERVICOS_DECOMPOSICAO = 500; // A decomposição só é aplicada a instâncias a partir desse tamanho
+    static inline const int ROTAS_POR_SUBPROBLEMA = 6; // Rotas próximas agrupadas em cada subproblema
+    static inline const int RODADAS_DECOMPOSICAO = 10; // Rodadas de particionamento + ILS paralelo + recombinação
+    static inline const int MAX_ITERACOES_ILS_SUBPROBLEMA = 30; // Orçamento do ILS em cada subproblema, por rodada
+
+    // Opções de execução, definidas pela linha de comando em main().
+    static inline bool MODO_WARM_START = false; // Reotimiza a partir de solucoes/sol-<nome>.txt, se existir
+    static inline bool MODO_PERFIL = false; // Mede cada fase com contadores de hardware (ou apenas tempo)
+    static inline bool MODO_DECOMPOSICAO = false; // Resolve instâncias grandes por decomposição em subproblemas paralelos
+    static inline int NUM_THREADS = 0; // Threads da decomposição (0 = uma por núcleo)
+    static inline double TOLERANCIA_GAP = 0.0; // O ILS para quando (custo - limite inferior) / limite inferior <= tolerância
+    static inline bool MODO_ALTERACOES = false; // Aplica as alterações de custo de <nome>.alt após resolver a instância
+};
+
+// --- CONTAGEM DE ALOCAÇÕES (APENAS PARA TESTES) ---
+// Compilando com -DCONTAR_ALOCACOES, o operator new global passa a contar as alocações e o ILS
+// verifica (assert) que nenhuma iteração aloca memória no heap depois do aquecimento.
+// A contagem é por thread, para que subproblemas resolvidos em paralelo não interfiram entre si.
+#ifdef CONTAR_ALOCACOES
+thread_local long long total_alocacoes = 0;
+
+// As substituições usam malloc/free de propósito; o GCC não reconhece o par e acusa -Wmismatched-new-delete.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void* operator new(size_t tamanho) {
+    total_alocacoes++;
+    if (void* p = malloc(tamanho ? tamanho : 1)) return p;
+    throw bad_alloc();
+}
+void* operator new[](size_t tamanho) { return operator new(tamanho); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+#pragma GCC diagnostic pop
+#endif
+
+// --- PERFILAMENTO (OPCIONAL) ---
+
+// Fases do resolvedor medidas pelo modo de perfilamento.
+enum FasePerfil {
+    FASE_LEITURA, FASE_MENORES_CAMINHOS, FASE_LIMITE_INFERIOR, FASE_SAVINGS,
+    FASE_VND_RELOCATE, FASE_VND_SWAP, FASE_VND_INTRA_ROTA, FASE_VND_EXCHANGE, FASE_LNS,
+    NUM_FASES
+};
+
+// Movimentos avaliados pela thread corrente; incrementado nos laços internos das vizinhanças.
+thread_local long long contador_movimentos = 0;
+
+// Coleta, por fase, tempo e contadores de hardware (ciclos, instruções, falhas de L1D/LLC e desvios
+// mal previstos) via perf_event_open. Os contadores medem apenas a thread que criou o perfilador.
+// Se não estiverem disponíveis (outro SO, permissões, VM), o relatório mostra somente os tempos.
+class Perfilador {
+    enum { CICLOS, INSTRUCOES, FALHAS_L1D, FALHAS_LLC, DESVIOS_ERRADOS, NUM_CONTADORES };
+
+public:
+    Perfilador() {
+        descritores.fill(-1);
+#ifdef __linux__
+        const pair<uint32_t, uint64_t> eventos[NUM_CONTADORES] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        };
+        for (int c = 0; c < NUM_CONTADORES; ++c) {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = eventos[c].first;
+            attr.config = eventos[c].second;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            // Com mais eventos que contadores físicos, o kernel os reveza; os tempos permitem extrapolar a contagem.
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            descritores[c] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+            if (descritores[c] == -1 && motivo_indisponivel.empty()) motivo_indisponivel = strerror(errno);
+        }
+#else
+        motivo_indisponivel = "perf_event_open disponivel apenas no Linux";
+#endif
+    }
+
+    ~Perfilador() {
+#ifdef __linux__
+        for (int fd : descritores) { if (fd != -1) close(fd); }
+#endif
+    }
+
+    Perfilador(const Perfilador&) = delete;
+    Perfilador& operator=(const Perfilador&) = delete;
+
+    // Leitura instantânea de tempo, movimentos e contadores, usada para medir o intervalo de uma fase.
+    struct Amostra {
+        high_resolution_clock::time_point instante;
+        long long movimentos = 0;
+        array<long long, NUM_CONTADORES> contadores{};
+        array<long long, NUM_CONTADORES> tempo_habilitado{}, tempo_ativo{}; // ns em que o evento esteve habilitado / realmente contando
+    };
+
+    Amostra amostrar() const {
+        Amostra a;
+        a.movimentos = contador_movimentos;
+#ifdef __linux__
+        for (int c = 0; c < NUM_CONTADORES; ++c) {
+            uint64_t leitura[3] = {0, 0, 0}; // valor, tempo habilitado, tempo ativo
+            if (descritores[c] != -1 && read(descritores[c], leitura, sizeof(leitura)) == sizeof(leitura)) {
+                a.contadores[c] = leitura[0]; a.tempo_habilitado[c] = leitura[1]; a.tempo_ativo[c] = leitura[2];
+            }
+        }
+#endif
+        a.instante = high_resolution_clock::now();
+        return a;
+    }
+
+    void registrar(FasePerfil fase, const Amostra& inicio) {
+        Amostra fim = amostrar();
+        Acumulado& acc = fases[fase];
+        acc.chamadas++;
+        acc.ns += duration_cast<nanoseconds>(fim.instante - inicio.instante).count();
+        acc.movimentos += fim.movimentos - inicio.movimentos;
+        for (int c = 0; c < NUM_CONTADORES; ++c) {
+            // Se o evento contou só parte do intervalo (multiplexação), escala a contagem para o intervalo inteiro.
+            long long delta = fim.contadores[c] - inicio.contadores[c];
+            long long habilitado = fim.tempo_habilitado[c] - inicio.tempo_habilitado[c];
+            long long ativo = fim.tempo_ativo[c] - inicio.tempo_ativo[c];
+            if (ativo > 0 && ativo < habilitado) delta = (long long)((long double)delta * habilitado / ativo);
+            else if (ativo == 0) delta = 0;
+            acc.contadores[c] += delta;
+        }
+    }
+
+    // Soma ao relatório as medições feitas por outra thread (por exemplo, um trabalhador da decomposição).
+    void incorporar(const Perfilador& outro) {
+        for (int f = 0; f < NUM_FASES; ++f) {
+            if (outro.fases[f].chamadas == 0) continue;
+            fases[f].chamadas += outro.fases[f].chamadas;
+            fases[f].ns += outro.fases[f].ns;
+            fases[f].movimentos += outro.fases[f].movimentos;
+            for (int c = 0; c < NUM_CONTADORES; ++c) fases[f].contadores[c] += outro.fases[f].contadores[c];
+        }
+        inclui_outras_threads = true;
+    }
+
+    // Imprime, por fase: tempo, chamadas, movimentos avaliados, IPC e falhas por movimento avaliado.
+    void imprimirRelatorio() const {
+        bool algum_contador = false;
+        for (int fd : descritores) { if (fd != -1) algum_contador = true; }
+        cout << "\n--- Perfil de Desempenho por Fase ---" << endl;
+        if (!algum_contador) cout << "Contadores de hardware indisponiveis (" << motivo_indisponivel << "); exibindo apenas tempos." << endl;
+        if (inclui_outras_threads) cout << "Inclui as threads da decomposicao: tempos somados entre threads (tempo de CPU, nao de parede)." << endl;
+        cout << left << setw(18) << "Fase" << right << setw(12) << "Tempo(ms)" << setw(10) << "Chamadas" << setw(14) << "Movimentos";
+        if (algum_contador) cout << setw(8) << "IPC" << setw(12) << "L1D/mov" << setw(12) << "LLC/mov" << setw(12) << "Desvio/mov";
+        cout << endl;
+        for (int f = 0; f < NUM_FASES; ++f) {
+            const Acumulado& acc = fases[f];
+            if (acc.chamadas == 0) continue;
+            cout << left << setw(18) << NOMES_FASES[f] << right << fixed << setprecision(3)
+                 << setw(12) << acc.ns / 1e6 << setw(10) << acc.chamadas << setw(14) << acc.movimentos;
+            if (algum_contador) {
+                auto porMovimento = [&](int c) -> double {
+                    return descritores[c] == -1 || acc.movimentos == 0 ? 0.0 : (double)acc.contadores[c] / acc.movimentos;
+                };
+                double ipc = (descritores[CICLOS] == -1 || descritores[INSTRUCOES] == -1 || acc.contadores[CICLOS] == 0)
+                           ? 0.0 : (double)acc.contadores[INSTRUCOES] / acc.contadores[CICLOS];
+                cout << setprecision(2) << setw(8) << ipc << setw(12) << porMovimento(FALHAS_L1D)
+                     << setw(12) << porMovimento(FALHAS_LLC) << setw(12) << porMovimento(DESVIOS_ERRADOS);
+            }
+            cout << defaultfloat << endl;
+        }
+    }
+
+private:
+    static inline const char* NOMES_FASES[NUM_FASES] = {
+        "Leitura", "Menores caminhos", "Limite inferior", "Savings",
+        "VND Relocate", "VND Swap", "VND Intra-rota", "VND (2,1)-Exch", "LNS"
+    };
+
+    struct Acumulado {
+        long long ns = 0, chamadas = 0, movimentos = 0;
+        array<long long, NUM_CONTADORES> contadores{};
+    };
+
+    array<int, NUM_CONTADORES> descritores;
+    array<Acumulado, NUM_FASES> fases;
+    string motivo_indisponivel;
+    bool inclui_outras_threads = false;
+};
+
+// Perfilador da thread corrente (nulo quando o modo de perfilamento está desligado).
+thread_local Perfilador* perfilador_ativo = nullptr;
+
+// Mede uma fase do início ao fim do escopo; não faz nada se não houver perfilador ativo.
+class MedicaoFase {
+public:
+    explicit MedicaoFase(FasePerfil fase) : fase(fase), perfilador(perfilador_ativo) {
+        if (perfilador) inicio = perfilador->amostrar();
+    }
+    ~MedicaoFase() { if (perfilador) perfilador->registrar(fase, inicio); }
+private:
+    FasePerfil fase;
+    Perfilador* perfilador;
+    Perfilador::Amostra inicio;
 };
 
 // --- ESTRUTURAS DE DADOS ---
@@ -57,12 +290,19 @@ struct Aresta {
     bool ehDirecionada;
 };
 
+// Novo custo de travessia de uma aresta/arco (linha "origem destino novo_custo" de um arquivo .alt).
+struct AlteracaoAresta {
+    int origem, destino;
+    int novo_custo;
+};
+
 // Estrutura de um serviço requerido (nó, aresta ou arco com demanda).
 struct ServicoRequerido {
     int id_servico;
     int no_origem, no_destino;
     int custo;
     int demanda;
+    bool bidirecional = false; // Aresta não direcionada: pode ser atendida em qualquer sentido
 };
 
 // Estrutura que representa uma rota completa de um veículo.
@@ -75,10 +315,13 @@ struct Rota {
 // --- CLASSES ---
 
 // Classe que encapsula a solução completa, composta por um conjunto de rotas.
+// Durante o ILS, rotas esvaziadas são mantidas como espaços reservados (com a memória já alocada)
+// e reaproveitadas quando uma nova rota precisa ser aberta; removerRotasVazias() compacta a solução.
 class Solucao {
 public:
     vector<Rota> rotas;
     long long custo_total_geral = 0; // Usa long long para o custo total
+    size_t reserva_por_rota = 0;     // Capacidade pré-alocada de serviços em cada rota nova
     
     // Calcula o custo total da solução somando os custos de todas as rotas individuais.
     void calcularCustoTotal() {
@@ -88,6 +331,46 @@ public:
         }
     }
     
+    // Pré-aloca espaço para até max_rotas rotas com até servicos_por_rota serviços cada e
+    // garante ao menos num_espacos rotas (as excedentes ficam vazias, como espaços reservados).
+    void reservar(size_t max_rotas, size_t servicos_por_rota, size_t num_espacos) {
+        reserva_por_rota = servicos_por_rota;
+        rotas.reserve(max(max_rotas, num_espacos));
+        for (auto& r : rotas) { r.servicos.reserve(servicos_por_rota); }
+        while (rotas.size() < num_espacos) {
+            rotas.emplace_back();
+            rotas.back().servicos.reserve(servicos_por_rota);
+        }
+    }
+    
+    // Abre uma rota vazia, reaproveitando um espaço reservado quando houver. Retorna seu índice.
+    int abrirRota() {
+        for (size_t i = 0; i < rotas.size(); ++i) {
+            if (rotas[i].servicos.empty()) return i;
+        }
+        rotas.emplace_back();
+        rotas.back().servicos.reserve(reserva_por_rota);
+        return rotas.size() - 1;
+    }
+    
+    // Copia outra solução reaproveitando a memória já alocada nesta (sem alocar após o aquecimento).
+    void copiarDe(const Solucao& outra) {
+        while (rotas.size() < outra.rotas.size()) {
+            rotas.emplace_back();
+            rotas.back().servicos.reserve(reserva_por_rota);
+        }
+        for (size_t i = 0; i < rotas.size(); ++i) {
+            if (i < outra.rotas.size()) { rotas[i] = outra.rotas[i]; }
+            else { rotas[i].servicos.clear(); rotas[i].custo_total = 0; rotas[i].demanda_total = 0; }
+        }
+        custo_total_geral = outra.custo_total_geral;
+    }
+    
+    // Remove as rotas sem serviços.
+    void removerRotasVazias() {
+        rotas.erase(remove_if(rotas.begin(), rotas.end(), [](const Rota& r){ return r.servicos.empty(); }), rotas.end());
+    }
+    
     // Exporta a solução encontrada para um arquivo de texto e imprime o resumo no console.
     void exportar(const string& nomeInstancia, long long tempo_total_ns, long long tempo_solucao_ns, const vector<int>& stats) {
         fs::create_directory("solucoes");
@@ -96,6 +379,7 @@ public:
         
         if (!out.is_open()) { cerr << "Erro ao criar arquivo de solução: " << nome_arquivo_saida << endl; return; }
         
+        removerRotasVazias();
         calcularCustoTotal();
         out << custo_total_geral << "\n";
         out << rotas.size() << "\n";
@@ -119,7 +403,7 @@ public:
         cout << "\n--- Estatisticas de Melhoria dos Operadores VND ---" << endl;
         cout << "Relocate (1): \t\t" << stats.at(1) << " melhorias" << endl;
         cout << "Swap (2): \t\t" << stats.at(2) << " melhorias" << endl;
-        cout << "2-Opt (3): \t\t" << stats.at(3) << " melhorias" << endl;
+        cout << "Intra-rota (3): \t" << stats.at(3) << " melhorias" << endl;
         cout << "(2,1)-Exchange (4): \t" << stats.at(4) << " melhorias" << endl;
         cout << "\nSolucao exportada com sucesso para: " << nome_arquivo_saida << endl;
     }
@@ -129,9 +413,13 @@ public:
 class Grafo {
 public:
     map<int, map<int, int>> distancias;
+    map<int, map<int, int>> custos_arcos; // Menor custo direto de cada arco (u, v); base das atualizações incrementais
+    long long versao = 0; // Identifica a matriz atual; muda sempre que as distâncias são recalculadas
     
     // Roda o algoritmo de Floyd-Warshall para pré-calcular os menores caminhos entre todos os pares de nós.
     void calcularMenoresCaminhos(const vector<Aresta>& arestas, const map<int, No>& nos) {
+        MedicaoFase medicao(FASE_MENORES_CAMINHOS);
+        versao = ++contador_versoes;
         set<int> nos_existentes;
         for (const auto& par : nos) { nos_existentes.insert(par.first); }
         nos_existentes.insert(ID_DEPOSITO);
@@ -144,6 +432,7 @@ public:
                 distancias[i][j] = (i == j) ? 0 : numeric_limits<int>::max();
             }
         }
+        custos_arcos.clear();
         for (const auto& aresta : arestas) {
             if (distancias.at(aresta.origem).at(aresta.destino) > aresta.custo) {
                 distancias[aresta.origem][aresta.destino] = aresta.custo;
@@ -153,6 +442,8 @@ public:
                     distancias[aresta.destino][aresta.origem] = aresta.custo;
                 }
             }
+            registrarArco(aresta.origem, aresta.destino, aresta.custo);
+            if (!aresta.ehDirecionada) registrarArco(aresta.destino, aresta.origem, aresta.custo);
         }
         vector<int> nos_ids(nos_existentes.begin(), nos_existentes.end());
         for (int k : nos_ids) {
@@ -168,6 +459,97 @@ public:
             }
         }
     }
+
+    // Atualiza as distâncias após a mudança de custo de alguns arcos, sem refazer o Floyd-Warshall.
+    // novos_custos traz o novo menor custo direto de cada arco (u, v) alterado. Os aumentos são aplicados
+    // primeiro: só as origens para as quais o arco era "justo" (d[s][u] + w == d[s][v]) podem mudar, e
+    // apenas delas o Dijkstra é refeito. Depois, cada redução é aplicada como d[i][j] = min(d[i][j],
+    // d[i][u] + w + d[v][j]), restrita às linhas i e colunas j que de fato melhoram.
+    // Devolve os pares (i, j) cuja distância pode ter mudado.
+    set<pair<int, int>> atualizarCustosArcos(const map<pair<int, int>, int>& novos_custos) {
+        MedicaoFase medicao(FASE_MENORES_CAMINHOS);
+        const int INF = numeric_limits<int>::max();
+        set<pair<int, int>> pares_alterados;
+
+        // 1. Aumentos: identifica as origens afetadas com os custos antigos e refaz o Dijkstra a partir delas.
+        set<int> origens_afetadas;
+        for (const auto& [arco, novo_custo] : novos_custos) {
+            auto [u, v] = arco;
+            int custo_antigo = custoArco(u, v);
+            if (novo_custo <= custo_antigo) continue;
+            for (const auto& [s, linha] : distancias) {
+                if (linha.at(u) != INF && (long long)linha.at(u) + custo_antigo == linha.at(v)) origens_afetadas.insert(s);
+            }
+            custos_arcos[u][v] = novo_custo;
+        }
+        for (int s : origens_afetadas) {
+            map<int, int> nova_linha = calcularDijkstra(s);
+            for (auto& [j, d] : distancias[s]) {
+                if (nova_linha.at(j) != d) { d = nova_linha.at(j); pares_alterados.insert({s, j}); }
+            }
+        }
+
+        // 2. Reduções: cada uma é exata sobre a matriz já corrigida, então podem ser aplicadas em sequência.
+        for (const auto& [arco, novo_custo] : novos_custos) {
+            auto [u, v] = arco;
+            if (novo_custo >= custoArco(u, v)) continue;
+            custos_arcos[u][v] = novo_custo;
+            if (u == v) continue;
+            vector<pair<int, long long>> linhas, colunas; // (i, d[i][u] + w) e (j, w + d[v][j])
+            for (const auto& [i, linha] : distancias) {
+                if (linha.at(u) == INF) continue;
+                long long ate_v = (long long)linha.at(u) + novo_custo;
+                if (ate_v < linha.at(v)) linhas.push_back({i, ate_v});
+            }
+            for (const auto& [j, d_vj] : distancias.at(v)) {
+                if (d_vj == INF) continue;
+                long long desde_u = (long long)novo_custo + d_vj;
+                if (desde_u < distancias.at(u).at(j)) colunas.push_back({j, d_vj});
+            }
+            for (const auto& [i, ate_v] : linhas) {
+                map<int, int>& linha = distancias[i];
+                for (const auto& [j, d_vj] : colunas) {
+                    long long candidato = ate_v + d_vj;
+                    if (candidato < linha.at(j)) { linha[j] = (int)candidato; pares_alterados.insert({i, j}); }
+                }
+            }
+        }
+        if (!pares_alterados.empty()) versao = ++contador_versoes;
+        return pares_alterados;
+    }
+private:
+    static inline atomic<long long> contador_versoes{0};
+
+    void registrarArco(int u, int v, int custo) {
+        auto it = custos_arcos[u].find(v);
+        if (it == custos_arcos[u].end() || custo < it->second) custos_arcos[u][v] = custo;
+    }
+
+    int custoArco(int u, int v) const {
+        auto it = custos_arcos.find(u);
+        if (it == custos_arcos.end()) return numeric_limits<int>::max();
+        auto it_v = it->second.find(v);
+        return it_v == it->second.end() ? numeric_limits<int>::max() : it_v->second;
+    }
+
+    // Menores distâncias a partir de uma origem, sobre os custos atuais dos arcos.
+    map<int, int> calcularDijkstra(int origem) const {
+        map<int, int> dist;
+        for (const auto& par : distancias) { dist[par.first] = numeric_limits<int>::max(); }
+        priority_queue<pair<long long, int>, vector<pair<long long, int>>, greater<>> fila;
+        dist[origem] = 0; fila.push({0, origem});
+        while (!fila.empty()) {
+            auto [d, u] = fila.top(); fila.pop();
+            if (d > dist.at(u)) continue;
+            auto it = custos_arcos.find(u);
+            if (it == custos_arcos.end()) continue;
+            for (const auto& [v, custo] : it->second) {
+                long long candidato = d + custo;
+                if (candidato < dist.at(v)) { dist[v] = (int)candidato; fila.push({candidato, v}); }
+            }
+        }
+        return dist;
+    }
 };
 
 // Classe responsável por ler e armazenar todos os dados de uma instância do problema.
@@ -198,12 +580,13 @@ private:
             if (no.demanda > 0) { servicos_requeridos.push_back({id++, no.id, no.id, 0, no.demanda}); } 
         }
         for (const auto& aresta : arestas) { 
-            if (aresta.ehRequerida && aresta.demanda > 0) { servicos_requeridos.push_back({id++, aresta.origem, aresta.destino, aresta.custo, aresta.demanda}); } 
+            if (aresta.ehRequerida && aresta.demanda > 0) { servicos_requeridos.push_back({id++, aresta.origem, aresta.destino, aresta.custo, aresta.demanda, !aresta.ehDirecionada}); } 
         }
     }
     
     // Lê o arquivo de instância (.dat) e preenche as estruturas de dados.
     void lerDeArquivo(const string& nomeArquivo) {
+        MedicaoFase medicao(FASE_LEITURA);
         extrairCapacidade(nomeArquivo);
         ifstream arquivo(nomeArquivo); 
         if (!arquivo.is_open()) { cerr << "Erro ao abrir arquivo: " << nomeArquivo << endl; return; }
@@ -223,8 +606,9 @@ private:
                 string e; int d, c; ss >> e >> d >> c; int id = stoi(e.substr(1)); nos[id] = {id, d}; 
             } else if (secao_atual == "ReE" && linha[0] == 'E') { 
                 string e; int o, d, c, dm, cs; ss >> e >> o >> d >> c >> dm >> cs; arestas.push_back({o, d, c, dm, true, false}); 
-            } else if (secao_atual == "EDGE" && isdigit(linha[0])) { 
-                int o, d, c; ss >> o >> d >> c; arestas.push_back({o, d, c, 0, false, false}); 
+            } else if (secao_atual == "EDGE") { 
+                if (isdigit(linha[0])) { int o, d, c; ss >> o >> d >> c; arestas.push_back({o, d, c, 0, false, false}); } 
+                else if (linha.rfind("NrE", 0) == 0) { string e; int o, d, c; ss >> e >> o >> d >> c; arestas.push_back({o, d, c, 0, false, false}); } 
             } else if (secao_atual == "ReA" && linha[0] == 'A') { 
                 string e; int o, d, c, dm, cs; ss >> e >> o >> d >> c >> dm >> cs; arestas.push_back({o, d, c, dm, true, true}); 
             } else if (secao_atual == "ARC") { 
@@ -254,28 +638,193 @@ void recalcularCustoERota(Rota& rota, const Grafo& grafo) {
 
 // Valida a solução final, verificando todas as restrições.
 bool validarSolucao(const Solucao& solucao, const Instancia& instancia) {
-    set<int> servicos_atendidos; int total_demandas = 0;
+    int max_id = 0;
+    for (const auto& s : instancia.servicos_requeridos) { max_id = max(max_id, s.id_servico); }
+    vector<bool> atendido(max_id + 1, false);
+    size_t num_atendidos = 0;
     for (const auto& rota : solucao.rotas) {
         if (rota.demanda_total > instancia.capacidade_veiculo) {
             cerr << "ERRO: Rota excede capacidade (" << rota.demanda_total << " > " << instancia.capacidade_veiculo << ")" << endl;
             return false;
         }
-        total_demandas += rota.demanda_total;
         for (const auto& servico : rota.servicos) {
-            if (servicos_atendidos.count(servico.id_servico)) {
+            if (servico.id_servico < 1 || servico.id_servico > max_id) {
+                cerr << "ERRO: Servico " << servico.id_servico << " nao pertence a instancia" << endl;
+                return false;
+            }
+            if (atendido[servico.id_servico]) {
                 cerr << "ERRO: Servico " << servico.id_servico << " atendido mais de uma vez" << endl;
                 return false;
             }
-            servicos_atendidos.insert(servico.id_servico);
+            atendido[servico.id_servico] = true;
+            num_atendidos++;
         }
     }
-    if (servicos_atendidos.size() != instancia.servicos_requeridos.size()) {
-        cerr << "ERRO: Numero de servicos atendidos (" << servicos_atendidos.size() << ") diferente do requerido (" << instancia.servicos_requeridos.size() << ")" << endl;
+    if (num_atendidos != instancia.servicos_requeridos.size()) {
+        cerr << "ERRO: Numero de servicos atendidos (" << num_atendidos << ") diferente do requerido (" << instancia.servicos_requeridos.size() << ")" << endl;
         return false;
     }
     return true;
 }
 
+// Custo incremental (negativo) de retirar da rota o trecho [pos, pos + tam), sem contar o custo
+// interno do trecho. Somado a custoIncrementalInsercao, dá a variação exata do custo total.
+long long custoIncrementalRemocao(const Rota& rota, size_t pos, size_t tam, const Grafo& grafo) {
+    const auto& sv = rota.servicos;
+    int antes = (pos == 0) ? ID_DEPOSITO : sv[pos - 1].no_destino;
+    int depois = (pos + tam == sv.size()) ? ID_DEPOSITO : sv[pos + tam].no_origem;
+    return (long long)grafo.distancias.at(antes).at(depois) - grafo.distancias.at(antes).at(sv[pos].no_origem)
+           - grafo.distancias.at(sv[pos + tam - 1].no_destino).at(depois);
+}
+
+// Custo incremental de inserir, antes da posição pos da rota, um trecho que começa em no_inicio e termina em no_fim.
+long long custoIncrementalInsercao(const Rota& rota, size_t pos, int no_inicio, int no_fim, const Grafo& grafo) {
+    const auto& sv = rota.servicos;
+    int antes = (pos == 0) ? ID_DEPOSITO : sv[pos - 1].no_destino;
+    int depois = (pos == sv.size()) ? ID_DEPOSITO : sv[pos].no_origem;
+    return (long long)grafo.distancias.at(antes).at(no_inicio) + grafo.distancias.at(no_fim).at(depois)
+           - grafo.distancias.at(antes).at(depois);
+}
+
+// Limite inferior para o custo ótimo de uma instância.
+struct LimiteInferior {
+    long long custo_servicos = 0;  // Soma dos custos de atendimento dos serviços requeridos
+    int min_veiculos = 0;          // ceil(demanda total / capacidade)
+    long long deslocamento = 0;    // Limite para o custo de deslocamento sem atendimento (deadheading)
+    long long valor = 0;           // custo_servicos + deslocamento (0 se o limite não for informativo)
+    bool informativo = true;       // Falso se o deslocamento mínimo exigir um par de nós sem caminho no grafo
+};
+
+// Resolve o problema de atribuição de custo mínimo (Húngaro, O(n^3)) sobre a matriz quadrada de custos.
+long long resolverAtribuicao(const vector<vector<long long>>& custo) {
+    const long long INF = numeric_limits<long long>::max() / 4;
+    int n = custo.size();
+    vector<long long> u(n + 1, 0), v(n + 1, 0), minv(n + 1);
+    vector<int> p(n + 1, 0), caminho(n + 1, 0);
+    vector<bool> usado(n + 1);
+    for (int i = 1; i <= n; ++i) {
+        p[0] = i; int j0 = 0;
+        fill(minv.begin(), minv.end(), INF);
+        fill(usado.begin(), usado.end(), false);
+        do {
+            usado[j0] = true;
+            int i0 = p[j0], j1 = 0; long long delta = INF;
+            for (int j = 1; j <= n; ++j) {
+                if (usado[j]) continue;
+                long long atual = custo[i0 - 1][j - 1] - u[i0] - v[j];
+                if (atual < minv[j]) { minv[j] = atual; caminho[j] = j0; }
+                if (minv[j] < delta) { delta = minv[j]; j1 = j; }
+            }
+            for (int j = 0; j <= n; ++j) {
+                if (usado[j]) { u[p[j]] += delta; v[j] -= delta; }
+                else { minv[j] -= delta; }
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+        do { int j1 = caminho[j0]; p[j0] = p[j1]; j0 = j1; } while (j0);
+    }
+    return -v[0];
+}
+
+// Calcula um limite inferior no estilo de Belenguer-Benavent: custo dos serviços + deslocamento mínimo.
+// O deslocamento é limitado por uma atribuição entre os serviços e ceil(demanda/capacidade) cópias do
+// depósito (cada serviço tem exatamente um antecessor e um sucessor, em qualquer sentido de atendimento
+// para as arestas não direcionadas). Toda solução viável pode ser
+// reduzida a essa atribuição pela desigualdade triangular, o que garante a validade do limite.
+LimiteInferior calcularLimiteInferior(const Instancia& instancia, const Grafo& grafo) {
+    MedicaoFase medicao(FASE_LIMITE_INFERIOR);
+    LimiteInferior lb;
+    const vector<ServicoRequerido>& servicos = instancia.servicos_requeridos;
+    if (servicos.empty()) return lb;
+
+    long long demanda_total = 0;
+    for (const auto& s : servicos) { lb.custo_servicos += s.custo; demanda_total += s.demanda; }
+    lb.min_veiculos = max(1LL, (demanda_total + instancia.capacidade_veiculo - 1) / instancia.capacidade_veiculo);
+
+    // Índices [0, n) são serviços e [n, n + k) são cópias do depósito. Uma aresta não direcionada pode ser
+    // atendida em qualquer sentido; o arco i -> j usa a combinação de extremos mais barata (relaxação que
+    // não exige que o sentido escolhido na entrada de j seja o mesmo da saída de j).
+    const int INALCANCAVEL = numeric_limits<int>::max();
+    int n = servicos.size(), k = min(lb.min_veiculos, n), total = n + k;
+    auto distanciaArco = [&](int i, int j) -> int {
+        int saidas[2] = {ID_DEPOSITO, ID_DEPOSITO}, entradas[2] = {ID_DEPOSITO, ID_DEPOSITO};
+        if (i < n) { saidas[0] = servicos[i].no_destino; saidas[1] = servicos[i].bidirecional ? servicos[i].no_origem : saidas[0]; }
+        if (j < n) { entradas[0] = servicos[j].no_origem; entradas[1] = servicos[j].bidirecional ? servicos[j].no_destino : entradas[0]; }
+        int menor = INALCANCAVEL;
+        for (int a : saidas) { for (int b : entradas) menor = min(menor, grafo.distancias.at(a).at(b)); }
+        return menor;
+    };
+
+    // Pares sem caminho (e laços/rotas vazias) são proibidos: custam mais que qualquer atribuição feita só
+    // com pares alcançáveis, de modo que uma atribuição ótima que use algum deles é detectada pelo valor.
+    long long maior_distancia = 0;
+    for (const auto& [u, linha] : grafo.distancias) {
+        for (const auto& [v, d] : linha) { if (d != INALCANCAVEL) maior_distancia = max(maior_distancia, (long long)d); }
+    }
+    const long long PROIBIDO = (maior_distancia + 1) * total + 1;
+    auto custoArco = [&](int i, int j) -> long long {
+        if (i == j || (i >= n && j >= n)) return PROIBIDO; // Sem laços e sem rotas vazias
+        int d = distanciaArco(i, j);
+        return d == INALCANCAVEL ? PROIBIDO : d;
+    };
+
+    if (total <= Parametros::MAX_NOS_LB_ATRIBUICAO) {
+        vector<vector<long long>> custo(total, vector<long long>(total));
+        for (int i = 0; i < total; ++i) {
+            for (int j = 0; j < total; ++j) { custo[i][j] = custoArco(i, j); }
+        }
+        lb.deslocamento = resolverAtribuicao(custo);
+    } else {
+        // Relaxação gulosa: cada nó paga seu arco de entrada (ou de saída) mais barato.
+        long long soma_entrada = 0, soma_saida = 0;
+        for (int j = 0; j < total; ++j) {
+            long long menor_entrada = PROIBIDO, menor_saida = PROIBIDO;
+            for (int i = 0; i < total; ++i) {
+                menor_entrada = min(menor_entrada, custoArco(i, j));
+                menor_saida = min(menor_saida, custoArco(j, i));
+            }
+            soma_entrada += menor_entrada; soma_saida += menor_saida;
+        }
+        lb.deslocamento = max(soma_entrada, soma_saida);
+    }
+    if (lb.deslocamento >= PROIBIDO) {
+        // Algum serviço não tem antecessor ou sucessor alcançável: não há limite útil nem gap a reportar.
+        lb.informativo = false; lb.deslocamento = 0; lb.valor = 0;
+        return lb;
+    }
+    lb.valor = lb.custo_servicos + lb.deslocamento;
+    return lb;
+}
+
+// Gap de otimalidade relativo ao limite inferior (infinito se o limite não for informativo).
+double calcularGap(long long custo, long long limite_inferior) {
+    if (limite_inferior <= 0) return numeric_limits<double>::infinity();
+    return (double)(custo - limite_inferior) / limite_inferior;
+}
+
+// Verdadeiro se alguma rota percorre um par de nós sem caminho no grafo (distância INT_MAX), caso em
+// que o custo da solução não é um custo real.
+bool usaTrechoInalcancavel(const Solucao& solucao, const Grafo& grafo) {
+    const int INALCANCAVEL = numeric_limits<int>::max();
+    for (const auto& rota : solucao.rotas) {
+        if (rota.servicos.empty()) continue;
+        int pos_atual = ID_DEPOSITO;
+        for (const auto& servico : rota.servicos) {
+            if (grafo.distancias.at(pos_atual).at(servico.no_origem) == INALCANCAVEL) return true;
+            pos_atual = servico.no_destino;
+        }
+        if (grafo.distancias.at(pos_atual).at(ID_DEPOSITO) == INALCANCAVEL) return true;
+    }
+    return false;
+}
+
+// Critério de parada antecipada: o gap em relação ao limite inferior atingiu Parametros::TOLERANCIA_GAP.
+// Nunca se aplica com limite não informativo (<= 0) ou se a solução usar um trecho inalcançável.
+bool atingiuToleranciaGap(const Solucao& solucao, const Grafo& grafo, long long limite_inferior) {
+    if (calcularGap(solucao.custo_total_geral, limite_inferior) > Parametros::TOLERANCIA_GAP) return false;
+    return !usaTrechoInalcancavel(solucao, grafo);
+}
+
 // Estrutura auxiliar para a Heurística de Savings.
 struct Economia {
     int id_servico_i, id_servico_j;
@@ -285,6 +834,7 @@ struct Economia {
 
 // Heurística construtiva de Clarke & Wright (Savings), focada em minimizar o número de rotas.
 Solucao construirSolucaoComSavings(const Instancia& instancia, const Grafo& grafo) {
+    MedicaoFase medicao(FASE_SAVINGS);
     Solucao solucao;
     const vector<ServicoRequerido>& servicos = instancia.servicos_requeridos;
     if (servicos.empty()) return solucao;
@@ -335,27 +885,203 @@ Solucao construirSolucaoComSavings(const Instancia& instancia, const Grafo& graf
     return solucao;
 }
 
+// --- OTIMIZAÇÃO INTRA-ROTA ---
+
+// Resequenciamento exato de rotas curtas pela programação dinâmica de Held-Karp sobre subconjuntos de serviços.
+// As tabelas são planas e alocadas uma única vez por thread; as sequências ótimas ficam em um cache de
+// mapeamento direto indexado pelo hash do conjunto de serviços, de modo que uma rota com o mesmo conteúdo
+// nunca é resolvida duas vezes para a mesma matriz de distâncias.
+class OtimizadorRotaExato {
+public:
+    OtimizadorRotaExato()
+        : dp((size_t(1) << Parametros::MAX_SERVICOS_DP) * Parametros::MAX_SERVICOS_DP),
+          anterior(dp.size()), cache(Parametros::TAMANHO_CACHE_DP) {}
+
+    // Reordena a rota na sequência de custo mínimo. Retorna true se o custo diminuiu.
+    bool otimizar(Rota& rota, const Grafo& grafo) {
+        int m = rota.servicos.size();
+        if (m < 2 || m > Parametros::MAX_SERVICOS_DP) return false;
+        ++contador_movimentos;
+
+        int ids[Parametros::MAX_SERVICOS_DP];
+        for (int i = 0; i < m; ++i) {
+            // Inserção ordenada: o conteúdo da rota, e não a ordem atual, define a chave do cache.
+            int id = rota.servicos[i].id_servico, pos = i;
+            while (pos > 0 && ids[pos - 1] > id) { ids[pos] = ids[pos - 1]; --pos; }
+            ids[pos] = id;
+        }
+        uint64_t chave = grafo.versao;
+        for (int i = 0; i < m; ++i) chave = misturarHash(chave ^ (uint64_t)ids[i]);
+
+        EntradaCache& entrada = cache[chave % cache.size()];
+        if (!(entrada.chave == chave && entrada.versao == grafo.versao && entrada.tamanho == m && equal(ids, ids + m, entrada.ids))) {
+            resolver(rota, grafo, entrada);
+            entrada.chave = chave; entrada.versao = grafo.versao; entrada.tamanho = m;
+            copy(ids, ids + m, entrada.ids);
+        }
+
+        ServicoRequerido originais[Parametros::MAX_SERVICOS_DP], reordenados[Parametros::MAX_SERVICOS_DP];
+        copy(rota.servicos.begin(), rota.servicos.end(), originais);
+        for (int i = 0; i < m; ++i) {
+            for (const auto& s : rota.servicos) { if (s.id_servico == entrada.ordem[i]) { reordenados[i] = s; break; } }
+        }
+        long long custo_original = rota.custo_total;
+        copy(reordenados, reordenados + m, rota.servicos.begin());
+        recalcularCustoERota(rota, grafo);
+        if (rota.custo_total < custo_original) return true;
+        // A sequência atual já é ótima (ou empata): mantém a ordem original.
+        copy(originais, originais + m, rota.servicos.begin());
+        recalcularCustoERota(rota, grafo);
+        return false;
+    }
+
+private:
+    struct EntradaCache {
+        uint64_t chave = 0;
+        long long versao = -1;
+        int tamanho = 0;
+        int ids[Parametros::MAX_SERVICOS_DP];   // Conjunto de serviços (ordenado), para confirmar o acerto
+        int ordem[Parametros::MAX_SERVICOS_DP]; // Sequência ótima de ids
+    };
+
+    vector<long long> dp;  // dp[mascara * MAX + j]: menor custo visitando 'mascara' e terminando no serviço j
+    vector<int8_t> anterior;
+    vector<EntradaCache> cache;
+
+    static uint64_t misturarHash(uint64_t x) {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    void resolver(const Rota& rota, const Grafo& grafo, EntradaCache& entrada) {
+        const int MAX = Parametros::MAX_SERVICOS_DP;
+        const long long INF = numeric_limits<long long>::max() / 4;
+        int m = rota.servicos.size();
+        const auto& sv = rota.servicos;
+
+        // Distâncias locais para evitar consultas ao mapa dentro do laço exponencial.
+        long long saida_deposito[MAX], volta_deposito[MAX], ligacao[MAX][MAX];
+        for (int i = 0; i < m; ++i) {
+            saida_deposito[i] = (long long)grafo.distancias.at(ID_DEPOSITO).at(sv[i].no_origem) + sv[i].custo;
+            volta_deposito[i] = grafo.distancias.at(sv[i].no_destino).at(ID_DEPOSITO);
+            for (int j = 0; j < m; ++j) {
+                ligacao[i][j] = (long long)grafo.distancias.at(sv[i].no_destino).at(sv[j].no_origem) + sv[j].custo;
+            }
+        }
+
+        int total = 1 << m;
+        fill(dp.begin(), dp.begin() + (size_t)total * MAX, INF);
+        for (int j = 0; j < m; ++j) { dp[(1 << j) * MAX + j] = saida_deposito[j]; anterior[(1 << j) * MAX + j] = -1; }
+        for (int mascara = 1; mascara < total; ++mascara) {
+            for (int j = 0; j < m; ++j) {
+                long long atual = dp[mascara * MAX + j];
+                if (!(mascara & (1 << j)) || atual >= INF) continue;
+                for (int k = 0; k < m; ++k) {
+                    if (mascara & (1 << k)) continue;
+                    int proxima = mascara | (1 << k);
+                    long long candidato = atual + ligacao[j][k];
+                    if (candidato < dp[proxima * MAX + k]) { dp[proxima * MAX + k] = candidato; anterior[proxima * MAX + k] = j; }
+                }
+            }
+        }
+
+        int ultimo = 0; long long melhor = INF;
+        for (int j = 0; j < m; ++j) {
+            long long custo = dp[(total - 1) * MAX + j] + volta_deposito[j];
+            if (custo < melhor) { melhor = custo; ultimo = j; }
+        }
+        int mascara = total - 1;
+        for (int pos = m - 1; pos >= 0; --pos) {
+            entrada.ordem[pos] = sv[ultimo].id_servico;
+            int antes = anterior[mascara * MAX + ultimo];
+            mascara ^= (1 << ultimo);
+            ultimo = antes;
+        }
+    }
+};
+
+// Resequenciamento exato da rota usando o otimizador da thread corrente.
+bool otimizarRotaExata(Rota& rota, const Grafo& grafo) {
+    static thread_local OtimizadorRotaExato otimizador;
+    return otimizador.otimizar(rota, grafo);
+}
+
+// 2-Opt: inverte a ordem de um trecho da rota. Aplica a primeira inversão que reduz o custo.
+bool aplicar2Opt(Rota& rota, const Grafo& grafo) {
+    auto& servicos = rota.servicos;
+    if (servicos.size() < 2) return false;
+    long long custo_rota_original = rota.custo_total;
+    for (size_t i = 0; i < servicos.size() - 1; ++i) {
+        for (size_t j = i + 1; j < servicos.size(); ++j) {
+            ++contador_movimentos;
+            reverse(servicos.begin() + i + 1, servicos.begin() + j + 1);
+            recalcularCustoERota(rota, grafo);
+            if (rota.custo_total < custo_rota_original) return true;
+            reverse(servicos.begin() + i + 1, servicos.begin() + j + 1);
+            recalcularCustoERota(rota, grafo);
+        }
+    }
+    return false;
+}
+
+// Or-Opt: move um trecho de 1 a 3 serviços consecutivos para outra posição da mesma rota.
+// Os movimentos são avaliados pelo custo incremental; aplica o primeiro que reduz o custo.
+bool aplicarOrOpt(Rota& rota, const Grafo& grafo) {
+    auto& sv = rota.servicos;
+    const auto& d = grafo.distancias;
+    int n = sv.size();
+    for (int tam = 1; tam <= 3 && tam < n; ++tam) {
+        for (int i = 0; i + tam <= n; ++i) {
+            int ini = sv[i].no_origem, fim = sv[i + tam - 1].no_destino;
+            int antes = (i == 0) ? ID_DEPOSITO : sv[i - 1].no_destino;
+            int depois = (i + tam == n) ? ID_DEPOSITO : sv[i + tam].no_origem;
+            long long delta_remocao = (long long)d.at(antes).at(depois) - d.at(antes).at(ini) - d.at(fim).at(depois);
+            // p percorre as posições de inserção na rota sem o trecho (reduzida[q] = sv[q < i ? q : q + tam]).
+            for (int p = 0; p <= n - tam; ++p) {
+                if (p == i) continue;
+                ++contador_movimentos;
+                int a = (p == 0) ? ID_DEPOSITO : sv[(p - 1 < i) ? p - 1 : p - 1 + tam].no_destino;
+                int b = (p == n - tam) ? ID_DEPOSITO : sv[(p < i) ? p : p + tam].no_origem;
+                long long delta = delta_remocao + d.at(a).at(ini) + d.at(fim).at(b) - d.at(a).at(b);
+                if (delta < 0) {
+                    if (p < i) rotate(sv.begin() + p, sv.begin() + i, sv.begin() + i + tam);
+                    else rotate(sv.begin() + i, sv.begin() + i + tam, sv.begin() + p + tam);
+                    recalcularCustoERota(rota, grafo);
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
 // Busca Local com Descida em Vizinhança Variável (VND). Explora sistematicamente múltiplos tipos de movimento.
 void buscaLocalVND(Solucao& solucao, const Grafo& grafo, int capacidade_veiculo, vector<int>& melhorias_por_vizinhanca) {
-    vector<int> vizinhancas = {1, 2, 3, 4}; // 1:Relocate, 2:Swap, 3:2-Opt, 4:(2,1)-Exchange
+    static const int vizinhancas[] = {1, 2, 3, 4}; // 1:Relocate, 2:Swap, 3:Intra-rota, 4:(2,1)-Exchange
+    const size_t num_vizinhancas = sizeof(vizinhancas) / sizeof(vizinhancas[0]);
     size_t k = 0;
-    while (k < vizinhancas.size()) {
+    const FasePerfil fase_da_vizinhanca[] = {FASE_VND_RELOCATE, FASE_VND_RELOCATE, FASE_VND_SWAP, FASE_VND_INTRA_ROTA, FASE_VND_EXCHANGE};
+    while (k < num_vizinhancas) {
         bool melhora_encontrada = false;
+        MedicaoFase medicao(fase_da_vizinhanca[vizinhancas[k]]);
         switch (vizinhancas[k]) {
         case 1: { // VIZINHANÇA 1: RELOCATE (INTER-ROTAS)
             for (size_t i = 0; i < solucao.rotas.size() && !melhora_encontrada; ++i) {
                 for (size_t l = 0; l < solucao.rotas[i].servicos.size() && !melhora_encontrada; ++l) {
                     ServicoRequerido servico_movido = solucao.rotas[i].servicos[l];
+                    long long delta_remocao = custoIncrementalRemocao(solucao.rotas[i], l, 1, grafo);
                     for (size_t j = 0; j < solucao.rotas.size() && !melhora_encontrada; ++j) {
-                        if (i == j || solucao.rotas[j].demanda_total + servico_movido.demanda > capacidade_veiculo) continue;
-                        long long custo_original = solucao.rotas[i].custo_total + solucao.rotas[j].custo_total;
+                        // Rotas vazias são espaços reservados: a busca local não abre novas rotas.
+                        if (i == j || solucao.rotas[j].servicos.empty() || solucao.rotas[j].demanda_total + servico_movido.demanda > capacidade_veiculo) continue;
                         for (size_t m = 0; m <= solucao.rotas[j].servicos.size(); ++m) {
-                            Rota temp_i = solucao.rotas[i]; Rota temp_j = solucao.rotas[j];
-                            temp_i.servicos.erase(temp_i.servicos.begin() + l);
-                            temp_j.servicos.insert(temp_j.servicos.begin() + m, servico_movido);
-                            recalcularCustoERota(temp_i, grafo); recalcularCustoERota(temp_j, grafo);
-                            if (temp_i.custo_total + temp_j.custo_total < custo_original) {
-                                solucao.rotas[i] = temp_i; solucao.rotas[j] = temp_j;
+                            ++contador_movimentos;
+                            long long delta = delta_remocao + custoIncrementalInsercao(solucao.rotas[j], m, servico_movido.no_origem, servico_movido.no_destino, grafo);
+                            if (delta < 0) {
+                                solucao.rotas[i].servicos.erase(solucao.rotas[i].servicos.begin() + l);
+                                solucao.rotas[j].servicos.insert(solucao.rotas[j].servicos.begin() + m, servico_movido);
+                                recalcularCustoERota(solucao.rotas[i], grafo); recalcularCustoERota(solucao.rotas[j], grafo);
                                 melhora_encontrada = true; break;
                             }
                         }
@@ -369,6 +1095,7 @@ void buscaLocalVND(Solucao& solucao, const Grafo& grafo, int capacidade_veiculo,
                 for (size_t j = i + 1; j < solucao.rotas.size() && !melhora_encontrada; ++j) {
                     for (size_t l = 0; l < solucao.rotas[i].servicos.size() && !melhora_encontrada; ++l) {
                         for (size_t m = 0; m < solucao.rotas[j].servicos.size(); ++m) {
+                            ++contador_movimentos;
                             if (solucao.rotas[i].demanda_total - solucao.rotas[i].servicos[l].demanda + solucao.rotas[j].servicos[m].demanda > capacidade_veiculo ||
                                 solucao.rotas[j].demanda_total - solucao.rotas[j].servicos[m].demanda + solucao.rotas[i].servicos[l].demanda > capacidade_veiculo) continue;
                             long long custo_original = solucao.rotas[i].custo_total + solucao.rotas[j].custo_total;
@@ -385,21 +1112,14 @@ void buscaLocalVND(Solucao& solucao, const Grafo& grafo, int capacidade_veiculo,
             }
             break;
         }
-        case 3: { // VIZINHANÇA 3: 2-OPT (INTRA-ROTA)
+        case 3: { // VIZINHANÇA 3: INTRA-ROTA (DP exata para rotas curtas; 2-Opt e Or-Opt para as demais)
             for (size_t r = 0; r < solucao.rotas.size() && !melhora_encontrada; ++r) {
-                auto& servicos = solucao.rotas[r].servicos;
-                if (servicos.size() < 2) continue;
-                long long custo_rota_original = solucao.rotas[r].custo_total;
-                for (size_t i = 0; i < servicos.size() - 1 && !melhora_encontrada; ++i) {
-                    for (size_t j = i + 1; j < servicos.size(); ++j) {
-                        reverse(servicos.begin() + i + 1, servicos.begin() + j + 1);
-                        recalcularCustoERota(solucao.rotas[r], grafo);
-                        if (solucao.rotas[r].custo_total < custo_rota_original) {
-                            melhora_encontrada = true; break;
-                        }
-                        reverse(servicos.begin() + i + 1, servicos.begin() + j + 1);
-                        recalcularCustoERota(solucao.rotas[r], grafo);
-                    }
+                Rota& rota = solucao.rotas[r];
+                if (rota.servicos.size() < 2) continue;
+                if ((int)rota.servicos.size() <= Parametros::MAX_SERVICOS_DP) {
+                    melhora_encontrada = otimizarRotaExata(rota, grafo);
+                } else {
+                    melhora_encontrada = aplicar2Opt(rota, grafo) || aplicarOrOpt(rota, grafo);
                 }
             }
             break;
@@ -411,15 +1131,15 @@ void buscaLocalVND(Solucao& solucao, const Grafo& grafo, int capacidade_veiculo,
                     ServicoRequerido s1 = solucao.rotas[i].servicos[l], s2 = solucao.rotas[i].servicos[l+1];
                     int demanda_par = s1.demanda + s2.demanda;
                     for (size_t j = 0; j < solucao.rotas.size() && !melhora_encontrada; ++j) {
-                        if (i == j || solucao.rotas[j].demanda_total + demanda_par > capacidade_veiculo) continue;
-                        long long custo_original = solucao.rotas[i].custo_total + solucao.rotas[j].custo_total;
+                        if (i == j || solucao.rotas[j].servicos.empty() || solucao.rotas[j].demanda_total + demanda_par > capacidade_veiculo) continue;
+                        long long delta_remocao = custoIncrementalRemocao(solucao.rotas[i], l, 2, grafo);
                         for (size_t m = 0; m <= solucao.rotas[j].servicos.size(); ++m) {
-                            Rota temp_i = solucao.rotas[i]; Rota temp_j = solucao.rotas[j];
-                            temp_i.servicos.erase(temp_i.servicos.begin() + l, temp_i.servicos.begin() + l + 2);
-                            temp_j.servicos.insert(temp_j.servicos.begin() + m, {s1, s2});
-                            recalcularCustoERota(temp_i, grafo); recalcularCustoERota(temp_j, grafo);
-                            if (temp_i.custo_total + temp_j.custo_total < custo_original) {
-                                solucao.rotas[i] = temp_i; solucao.rotas[j] = temp_j;
+                            ++contador_movimentos;
+                            long long delta = delta_remocao + custoIncrementalInsercao(solucao.rotas[j], m, s1.no_origem, s2.no_destino, grafo);
+                            if (delta < 0) {
+                                solucao.rotas[i].servicos.erase(solucao.rotas[i].servicos.begin() + l, solucao.rotas[i].servicos.begin() + l + 2);
+                                solucao.rotas[j].servicos.insert(solucao.rotas[j].servicos.begin() + m, {s1, s2});
+                                recalcularCustoERota(solucao.rotas[i], grafo); recalcularCustoERota(solucao.rotas[j], grafo);
                                 melhora_encontrada = true; break;
                             }
                         }
@@ -436,68 +1156,585 @@ void buscaLocalVND(Solucao& solucao, const Grafo& grafo, int capacidade_veiculo,
             k++;
         }
     }
-    solucao.rotas.erase(remove_if(solucao.rotas.begin(), solucao.rotas.end(), [](const Rota& r){ return r.servicos.empty(); }), solucao.rotas.end());
     solucao.calcularCustoTotal();
 }
 
+// Insere um serviço na posição de menor custo adicional entre as rotas com capacidade disponível.
+// Se nenhuma rota comportar o serviço, abre uma nova rota. Retorna o índice da rota que o recebeu.
+int inserirServicoMaisBarato(Solucao& solucao, const ServicoRequerido& servico_a_inserir, const Grafo& grafo, int capacidade_veiculo) {
+    long long melhor_custo_insercao = numeric_limits<long long>::max();
+    int melhor_rota_idx = -1;
+    int melhor_pos_idx = -1;
+    for (size_t i = 0; i < solucao.rotas.size(); ++i) {
+        if (solucao.rotas[i].servicos.empty()) continue; // Espaço reservado: só é usado se nenhuma rota comportar o serviço
+        if (solucao.rotas[i].demanda_total + servico_a_inserir.demanda <= capacidade_veiculo) {
+            for (size_t j = 0; j <= solucao.rotas[i].servicos.size(); ++j) {
+                ++contador_movimentos;
+                long long delta = custoIncrementalInsercao(solucao.rotas[i], j, servico_a_inserir.no_origem, servico_a_inserir.no_destino, grafo) + servico_a_inserir.custo;
+                if (delta < melhor_custo_insercao) {
+                    melhor_custo_insercao = delta;
+                    melhor_rota_idx = i;
+                    melhor_pos_idx = j;
+                }
+            }
+        }
+    }
+    if (melhor_rota_idx != -1) {
+        solucao.rotas[melhor_rota_idx].servicos.insert(solucao.rotas[melhor_rota_idx].servicos.begin() + melhor_pos_idx, servico_a_inserir);
+        recalcularCustoERota(solucao.rotas[melhor_rota_idx], grafo);
+        return melhor_rota_idx;
+    }
+    int nova_rota_idx = solucao.abrirRota();
+    solucao.rotas[nova_rota_idx].servicos.push_back(servico_a_inserir);
+    recalcularCustoERota(solucao.rotas[nova_rota_idx], grafo);
+    return nova_rota_idx;
+}
+
+// Buffers reutilizáveis da perturbação LNS, um conjunto por thread. A marcação dos serviços removidos
+// usa um vetor indexado pelo id com carimbo de época, que é "limpo" apenas incrementando a época.
+struct EspacoTrabalhoLNS {
+    vector<ServicoRequerido> todos_servicos;
+    vector<ServicoRequerido> servicos_removidos;
+    vector<unsigned> marca_removido;
+    unsigned epoca = 0;
+};
+
 // Perturbação do tipo Large Neighborhood Search (LNS).
 void perturbarComLNS(Solucao& solucao, const Grafo& grafo, mt19937& gen, int capacidade_veiculo) {
     if (solucao.rotas.empty()) return;
+    MedicaoFase medicao(FASE_LNS);
+    static thread_local EspacoTrabalhoLNS espaco;
 
-    vector<ServicoRequerido> todos_servicos;
+    auto& todos_servicos = espaco.todos_servicos;
+    todos_servicos.clear();
+    int max_id = 0;
     for(const auto& rota : solucao.rotas) {
         todos_servicos.insert(todos_servicos.end(), rota.servicos.begin(), rota.servicos.end());
+        for (const auto& s : rota.servicos) max_id = max(max_id, s.id_servico);
     }
     if (todos_servicos.empty()) return;
 
     int num_a_remover = floor(todos_servicos.size() * Parametros::TAXA_DESTRUICAO);
     if (num_a_remover == 0 && !todos_servicos.empty()) num_a_remover = 1;
 
-    vector<ServicoRequerido> servicos_removidos;
-    set<int> ids_removidos;
+    if ((int)espaco.marca_removido.size() <= max_id) espaco.marca_removido.resize(max_id + 1, 0);
+    if (++espaco.epoca == 0) { fill(espaco.marca_removido.begin(), espaco.marca_removido.end(), 0); espaco.epoca = 1; }
+    const unsigned epoca = espaco.epoca;
+
+    auto& servicos_removidos = espaco.servicos_removidos;
+    servicos_removidos.clear();
     shuffle(todos_servicos.begin(), todos_servicos.end(), gen);
     for(int i=0; i<num_a_remover; ++i) {
         servicos_removidos.push_back(todos_servicos[i]);
-        ids_removidos.insert(todos_servicos[i].id_servico);
+        espaco.marca_removido[todos_servicos[i].id_servico] = epoca;
     }
     
+    // Recalcula as rotas afetadas pela destruição para que a reinserção veja demandas e custos atualizados.
     for(auto& rota : solucao.rotas) {
+        size_t tamanho_anterior = rota.servicos.size();
         rota.servicos.erase(remove_if(rota.servicos.begin(), rota.servicos.end(), 
-            [&](const ServicoRequerido& s){ return ids_removidos.count(s.id_servico); }),
+            [&](const ServicoRequerido& s){ return espaco.marca_removido[s.id_servico] == epoca; }),
             rota.servicos.end());
+        if (rota.servicos.size() != tamanho_anterior) recalcularCustoERota(rota, grafo);
     }
 
     for(const auto& servico_a_inserir : servicos_removidos) {
-        long long melhor_custo_insercao = numeric_limits<long long>::max();
-        int melhor_rota_idx = -1;
-        int melhor_pos_idx = -1;
-        for (size_t i = 0; i < solucao.rotas.size(); ++i) {
-            if (solucao.rotas[i].demanda_total + servico_a_inserir.demanda <= capacidade_veiculo) {
-                for (size_t j = 0; j <= solucao.rotas[i].servicos.size(); ++j) {
-                    long long no_anterior = (j == 0) ? ID_DEPOSITO : solucao.rotas[i].servicos[j-1].no_destino;
-                    long long no_posterior = (j == solucao.rotas[i].servicos.size()) ? ID_DEPOSITO : solucao.rotas[i].servicos[j].no_origem;
-                    long long delta = (grafo.distancias.at(no_anterior).at(servico_a_inserir.no_origem) + servico_a_inserir.custo + grafo.distancias.at(servico_a_inserir.no_destino).at(no_posterior)) - grafo.distancias.at(no_anterior).at(no_posterior);
-                    if (delta < melhor_custo_insercao) {
-                        melhor_custo_insercao = delta;
-                        melhor_rota_idx = i;
-                        melhor_pos_idx = j;
-                    }
-                }
+        inserirServicoMaisBarato(solucao, servico_a_inserir, grafo, capacidade_veiculo);
+    }
+    
+    solucao.calcularCustoTotal();
+}
+
+// Maior número de serviços que cabe em uma rota: quantos dos serviços de menor demanda somam até a capacidade.
+size_t limiteServicosPorRota(const Solucao& solucao, int capacidade_veiculo) {
+    vector<int> demandas;
+    for (const auto& rota : solucao.rotas) {
+        for (const auto& s : rota.servicos) demandas.push_back(s.demanda);
+    }
+    sort(demandas.begin(), demandas.end());
+    size_t quantidade = 0; long long soma = 0;
+    while (quantidade < demandas.size() && soma + demandas[quantidade] <= capacidade_veiculo) { soma += demandas[quantidade++]; }
+    for (const auto& rota : solucao.rotas) quantidade = max(quantidade, rota.servicos.size());
+    return quantidade;
+}
+
+// Iterated Local Search: perturba a melhor solução base com LNS e a refina com VND até esgotar o orçamento.
+// Recebe uma solução já otimizada pelo VND e a substitui pela melhor solução encontrada.
+// Para antecipadamente quando o gap em relação ao limite inferior atinge Parametros::TOLERANCIA_GAP
+// (limite_inferior <= 0 desativa o critério). Retorna o número de iterações executadas.
+// As três soluções do laço reservam toda a memória de antemão e são copiadas com copiarDe(),
+// de modo que, após o aquecimento, as iterações não fazem alocações no heap.
+int executarILS(Solucao& melhor_solucao_geral, const Grafo& grafo, int capacidade_veiculo, mt19937& gen, vector<int>& melhorias_por_vizinhanca, int max_iteracoes, long long limite_inferior) {
+    size_t num_servicos = 0;
+    for (const auto& rota : melhor_solucao_geral.rotas) num_servicos += rota.servicos.size();
+    size_t servicos_por_rota = limiteServicosPorRota(melhor_solucao_geral, capacidade_veiculo);
+
+    // Cada perturbação abre no máximo uma rota por serviço removido; essas rotas ficam pré-criadas.
+    size_t num_espacos = melhor_solucao_geral.rotas.size() + (size_t)ceil(num_servicos * Parametros::TAXA_DESTRUICAO) + 1;
+
+    Solucao solucao_base_para_perturbacao, solucao_de_trabalho;
+    for (Solucao* s : {&melhor_solucao_geral, &solucao_base_para_perturbacao, &solucao_de_trabalho}) {
+        s->reservar(num_servicos, servicos_por_rota, num_espacos);
+    }
+    solucao_base_para_perturbacao.copiarDe(melhor_solucao_geral);
+    int iter_sem_melhora = 0;
+    int i = 0;
+    
+    for (; i < max_iteracoes && iter_sem_melhora < Parametros::MAX_ITER_SEM_MELHORA; ++i) {
+        if (atingiuToleranciaGap(melhor_solucao_geral, grafo, limite_inferior)) break;
+#ifdef CONTAR_ALOCACOES
+        long long alocacoes_antes = total_alocacoes;
+#endif
+        solucao_de_trabalho.copiarDe(solucao_base_para_perturbacao);
+        
+        perturbarComLNS(solucao_de_trabalho, grafo, gen, capacidade_veiculo);
+        buscaLocalVND(solucao_de_trabalho, grafo, capacidade_veiculo, melhorias_por_vizinhanca);
+        
+        if (solucao_de_trabalho.custo_total_geral < melhor_solucao_geral.custo_total_geral) {
+            melhor_solucao_geral.copiarDe(solucao_de_trabalho);
+        }
+        
+        if (solucao_de_trabalho.custo_total_geral < solucao_base_para_perturbacao.custo_total_geral) {
+            solucao_base_para_perturbacao.copiarDe(solucao_de_trabalho);
+            iter_sem_melhora = 0;
+        } else {
+            iter_sem_melhora++;
+        }
+#ifdef CONTAR_ALOCACOES
+        assert((i < Parametros::ITERACOES_AQUECIMENTO || total_alocacoes == alocacoes_antes) &&
+               "Iteracao do ILS alocou memoria apos o aquecimento");
+#endif
+    }
+    melhor_solucao_geral.removerRotasVazias();
+    return i;
+}
+
+// --- DECOMPOSIÇÃO PARA INSTÂNCIAS GRANDES ---
+
+// Nó representativo (medoide) de uma rota no espaço de distâncias do grafo: o extremo de serviço
+// com a menor soma de distâncias (ida e volta) até os demais extremos da rota.
+int calcularBaricentroRota(const Rota& rota, const Grafo& grafo) {
+    vector<int> extremos;
+    for (const auto& s : rota.servicos) { extremos.push_back(s.no_origem); extremos.push_back(s.no_destino); }
+    if (extremos.empty()) return ID_DEPOSITO;
+    int melhor_no = extremos[0]; long long menor_soma = numeric_limits<long long>::max();
+    for (int candidato : extremos) {
+        long long soma = 0;
+        for (int outro : extremos) { soma += (long long)grafo.distancias.at(candidato).at(outro) + grafo.distancias.at(outro).at(candidato); }
+        if (soma < menor_soma) { menor_soma = soma; melhor_no = candidato; }
+    }
+    return melhor_no;
+}
+
+// Particiona as rotas em grupos de até ROTAS_POR_SUBPROBLEMA rotas próximas. As sementes são tomadas
+// a partir da rota de índice 'deslocamento', de modo que rodadas diferentes formam agrupamentos diferentes.
+vector<vector<int>> particionarRotas(const Solucao& solucao, const Grafo& grafo, int deslocamento) {
+    int num_rotas = solucao.rotas.size();
+    vector<int> baricentros(num_rotas);
+    for (int r = 0; r < num_rotas; ++r) baricentros[r] = calcularBaricentroRota(solucao.rotas[r], grafo);
+
+    vector<vector<int>> grupos;
+    vector<bool> atribuida(num_rotas, false);
+    for (int passo = 0; passo < num_rotas; ++passo) {
+        int semente = (passo + deslocamento) % num_rotas;
+        if (atribuida[semente]) continue;
+        atribuida[semente] = true;
+        vector<pair<long long, int>> candidatas;
+        for (int r = 0; r < num_rotas; ++r) {
+            if (atribuida[r]) continue;
+            long long dist = (long long)grafo.distancias.at(baricentros[semente]).at(baricentros[r]) +
+                             grafo.distancias.at(baricentros[r]).at(baricentros[semente]);
+            candidatas.push_back({dist, r});
+        }
+        size_t vizinhas = min(candidatas.size(), (size_t)Parametros::ROTAS_POR_SUBPROBLEMA - 1);
+        partial_sort(candidatas.begin(), candidatas.begin() + vizinhas, candidatas.end());
+        vector<int> grupo = {semente};
+        for (size_t c = 0; c < vizinhas; ++c) { grupo.push_back(candidatas[c].second); atribuida[candidatas[c].second] = true; }
+        grupos.push_back(grupo);
+    }
+    return grupos;
+}
+
+// Threads que resolvem os subproblemas da decomposição. Ficam vivas durante todas as rodadas, de modo que
+// o estado thread_local (cache do otimizador exato, buffers do LNS) é aquecido uma única vez e reaproveitado:
+// uma rota que não mudou entre rodadas não é resolvida de novo. Com o perfilamento ativo, cada thread mede
+// com o seu próprio Perfilador (os contadores de hardware são por thread), incorporado ao principal no fim.
+class PoolTrabalhadores {
+public:
+    PoolTrabalhadores(int num_threads, bool com_perfil) : perfiladores(com_perfil ? num_threads : 0) {
+        for (int t = 0; t < num_threads; ++t) threads.emplace_back([this, t] { executarLaco(t); });
+    }
+
+    ~PoolTrabalhadores() { encerrar(); }
+
+    PoolTrabalhadores(const PoolTrabalhadores&) = delete;
+    PoolTrabalhadores& operator=(const PoolTrabalhadores&) = delete;
+
+    // Executa tarefa(i) para todo i em [0, num_tarefas), distribuindo os índices entre as threads.
+    // Retorna quando todas as tarefas terminarem.
+    void executar(size_t num_tarefas, const function<void(size_t)>& tarefa) {
+        {
+            lock_guard<mutex> trava(mtx);
+            tarefa_atual = &tarefa; total_tarefas = num_tarefas; proxima_tarefa = 0;
+            threads_ocupadas = threads.size(); ++lote;
+        }
+        cv_lote.notify_all();
+        unique_lock<mutex> trava(mtx);
+        cv_fim.wait(trava, [&] { return threads_ocupadas == 0; });
+        tarefa_atual = nullptr;
+    }
+
+    // Finaliza as threads; depois disso os perfis de cada uma podem ser incorporados.
+    void encerrar() {
+        { lock_guard<mutex> trava(mtx); encerrando = true; }
+        cv_lote.notify_all();
+        for (auto& th : threads) { if (th.joinable()) th.join(); }
+    }
+
+    void incorporarPerfis(Perfilador& destino) const {
+        for (const auto& p : perfiladores) { if (p) destino.incorporar(*p); }
+    }
+
+private:
+    void executarLaco(int t) {
+        if (!perfiladores.empty()) { perfiladores[t] = make_unique<Perfilador>(); perfilador_ativo = perfiladores[t].get(); }
+        long long lote_visto = 0;
+        while (true) {
+            {
+                unique_lock<mutex> trava(mtx);
+                cv_lote.wait(trava, [&] { return encerrando || lote != lote_visto; });
+                if (encerrando) break;
+                lote_visto = lote;
+            }
+            for (size_t i = proxima_tarefa++; i < total_tarefas; i = proxima_tarefa++) (*tarefa_atual)(i);
+            {
+                lock_guard<mutex> trava(mtx);
+                if (--threads_ocupadas == 0) cv_fim.notify_one();
             }
         }
-        if (melhor_rota_idx != -1) {
-            solucao.rotas[melhor_rota_idx].servicos.insert(solucao.rotas[melhor_rota_idx].servicos.begin() + melhor_pos_idx, servico_a_inserir);
-            recalcularCustoERota(solucao.rotas[melhor_rota_idx], grafo);
+        perfilador_ativo = nullptr;
+    }
+
+    vector<thread> threads;
+    vector<unique_ptr<Perfilador>> perfiladores; // Um por thread, criado pela própria thread
+    mutex mtx;
+    condition_variable cv_lote, cv_fim;
+    const function<void(size_t)>* tarefa_atual = nullptr;
+    size_t total_tarefas = 0;
+    atomic<size_t> proxima_tarefa{0};
+    size_t threads_ocupadas = 0;
+    long long lote = 0;
+    bool encerrando = false;
+};
+
+// Decomposição no estilo POPMUSIC: a cada rodada, as rotas são agrupadas por proximidade e cada grupo
+// é otimizado como um subproblema independente (VND + ILS) em paralelo. Como os grupos têm serviços
+// disjuntos e o ILS nunca piora a solução recebida, a recombinação é a simples união das rotas.
+// Retorna o número de rodadas executadas.
+int executarDecomposicao(Solucao& solucao, const Grafo& grafo, int capacidade_veiculo, mt19937& gen, vector<int>& melhorias_por_vizinhanca, long long limite_inferior) {
+    int num_threads = Parametros::NUM_THREADS > 0 ? Parametros::NUM_THREADS : max(1u, thread::hardware_concurrency());
+    Perfilador* perfilador_principal = perfilador_ativo;
+    PoolTrabalhadores pool(num_threads, perfilador_principal != nullptr);
+
+    // Medição da vazão: melhoria obtida por segundo de CPU (somado entre as threads) e de parede.
+    long long custo_inicial = solucao.custo_total_geral;
+    clock_t cpu_inicio = clock();
+    auto parede_inicio = high_resolution_clock::now();
+
+    int rodada = 0;
+    for (; rodada < Parametros::RODADAS_DECOMPOSICAO; ++rodada) {
+        if (atingiuToleranciaGap(solucao, grafo, limite_inferior)) break;
+        solucao.removerRotasVazias();
+        if (solucao.rotas.empty()) break;
+        vector<vector<int>> grupos = particionarRotas(solucao, grafo, rodada * max(1, Parametros::ROTAS_POR_SUBPROBLEMA / 2));
+
+        vector<Solucao> subproblemas(grupos.size());
+        vector<vector<int>> melhorias_sub(grupos.size(), vector<int>(melhorias_por_vizinhanca.size(), 0));
+        vector<unsigned> sementes(grupos.size());
+        for (size_t g = 0; g < grupos.size(); ++g) {
+            for (int r : grupos[g]) subproblemas[g].rotas.push_back(solucao.rotas[r]);
+            subproblemas[g].calcularCustoTotal();
+            sementes[g] = gen();
+        }
+
+        pool.executar(subproblemas.size(), [&](size_t g) {
+            mt19937 gen_local(sementes[g]);
+            buscaLocalVND(subproblemas[g], grafo, capacidade_veiculo, melhorias_sub[g]);
+            executarILS(subproblemas[g], grafo, capacidade_veiculo, gen_local, melhorias_sub[g], Parametros::MAX_ITERACOES_ILS_SUBPROBLEMA, 0);
+        });
+
+        solucao.rotas.clear();
+        for (size_t g = 0; g < subproblemas.size(); ++g) {
+            solucao.rotas.insert(solucao.rotas.end(), subproblemas[g].rotas.begin(), subproblemas[g].rotas.end());
+            for (size_t v = 0; v < melhorias_por_vizinhanca.size(); ++v) melhorias_por_vizinhanca[v] += melhorias_sub[g][v];
+        }
+        solucao.calcularCustoTotal();
+    }
+
+    pool.encerrar();
+    if (perfilador_principal) pool.incorporarPerfis(*perfilador_principal);
+
+    double cpu_s = (double)(clock() - cpu_inicio) / CLOCKS_PER_SEC;
+    double parede_s = duration_cast<microseconds>(high_resolution_clock::now() - parede_inicio).count() / 1e6;
+    long long melhoria = custo_inicial - solucao.custo_total_geral;
+    cout << "Decomposicao com " << num_threads << " threads: melhoria " << melhoria << " em " << fixed << setprecision(2)
+         << parede_s << " s de parede / " << cpu_s << " s de CPU (" << (cpu_s > 0 ? melhoria / cpu_s : 0.0)
+         << " por s de CPU, " << (parede_s > 0 ? melhoria / parede_s : 0.0) << " por s de parede)" << defaultfloat << endl;
+    return rodada;
+}
+
+// Lê as rotas de um arquivo sol-*.txt (linhas "(S id,o,d)") e as mapeia sobre a instância atual.
+// Serviços que deixaram de existir são descartados, rotas acima da capacidade são reparadas e
+// serviços novos ou excedentes são reinseridos. Marca em rota_afetada as rotas que mudaram.
+bool carregarSolucaoAnterior(const string& caminho, const Instancia& instancia, const Grafo& grafo, Solucao& solucao, vector<bool>& rota_afetada) {
+    ifstream arq(caminho);
+    if (!arq.is_open()) return false;
+
+    const vector<ServicoRequerido>& servicos = instancia.servicos_requeridos;
+    map<pair<int, int>, vector<int>> indices_por_extremos;
+    for (size_t i = 0; i < servicos.size(); ++i) {
+        indices_por_extremos[{servicos[i].no_origem, servicos[i].no_destino}].push_back(i);
+    }
+    vector<bool> atendido(servicos.size(), false);
+
+    // Localiza o serviço da instância atual correspondente a (id, o, d); prefere o mesmo id se os extremos coincidirem.
+    auto localizarServico = [&](int id, int o, int d) -> int {
+        if (id >= 1 && id <= (int)servicos.size() && !atendido[id - 1] &&
+            servicos[id - 1].no_origem == o && servicos[id - 1].no_destino == d) return id - 1;
+        for (const auto& chave : {make_pair(o, d), make_pair(d, o)}) {
+            auto it = indices_por_extremos.find(chave);
+            if (it == indices_por_extremos.end()) continue;
+            for (int idx : it->second) { if (!atendido[idx]) return idx; }
+        }
+        return -1;
+    };
+
+    string linha;
+    for (int i = 0; i < 4; ++i) { if (!getline(arq, linha)) return false; } // Cabeçalho: custo, rotas, tempos
+
+    vector<ServicoRequerido> pendentes;
+    while (getline(arq, linha)) {
+        stringstream ss(linha);
+        int zero, dia, id_rota, demanda_lida; long long custo_lido;
+        if (!(ss >> zero >> dia >> id_rota >> demanda_lida >> custo_lido)) continue;
+
+        Rota rota; bool alterada = false;
+        size_t pos = 0;
+        while ((pos = linha.find("(S ", pos)) != string::npos) {
+            int id, o, d;
+            if (sscanf(linha.c_str() + pos, "(S %d,%d,%d)", &id, &o, &d) == 3) {
+                int idx = localizarServico(id, o, d);
+                if (idx == -1) { alterada = true; } // Serviço removido da instância
+                else { atendido[idx] = true; rota.servicos.push_back(servicos[idx]); }
+            }
+            pos += 3;
+        }
+        if (rota.servicos.empty()) continue;
+        recalcularCustoERota(rota, grafo);
+        if (rota.demanda_total != demanda_lida || rota.custo_total != custo_lido) alterada = true;
+
+        // Reparo de capacidade: retira o serviço cuja remoção mais economiza até a rota caber no veículo.
+        while (rota.demanda_total > instancia.capacidade_veiculo) {
+            size_t melhor_idx = 0; long long menor_custo = numeric_limits<long long>::max();
+            for (size_t l = 0; l < rota.servicos.size(); ++l) {
+                Rota temp = rota;
+                temp.servicos.erase(temp.servicos.begin() + l);
+                recalcularCustoERota(temp, grafo);
+                if (temp.custo_total < menor_custo) { menor_custo = temp.custo_total; melhor_idx = l; }
+            }
+            pendentes.push_back(rota.servicos[melhor_idx]);
+            rota.servicos.erase(rota.servicos.begin() + melhor_idx);
+            recalcularCustoERota(rota, grafo);
+            alterada = true;
+        }
+        solucao.rotas.push_back(rota);
+        rota_afetada.push_back(alterada);
+    }
+
+    // Serviços novos (ou não encontrados no arquivo) também precisam ser inseridos.
+    for (size_t i = 0; i < servicos.size(); ++i) {
+        if (!atendido[i]) pendentes.push_back(servicos[i]);
+    }
+    for (const auto& servico : pendentes) {
+        int idx_rota = inserirServicoMaisBarato(solucao, servico, grafo, instancia.capacidade_veiculo);
+        if (idx_rota >= (int)rota_afetada.size()) rota_afetada.resize(idx_rota + 1, false);
+        rota_afetada[idx_rota] = true;
+    }
+    solucao.calcularCustoTotal();
+    return !solucao.rotas.empty();
+}
+
+// Aplica VND e ILS somente sobre as rotas marcadas em rota_afetada, mantendo as demais intactas.
+void reotimizarRotasAfetadas(Solucao& solucao, const vector<bool>& rota_afetada, const Grafo& grafo, int capacidade_veiculo, mt19937& gen, vector<int>& melhorias_por_vizinhanca) {
+    Solucao subproblema, intactas;
+    for (size_t i = 0; i < solucao.rotas.size(); ++i) {
+        if (i < rota_afetada.size() && rota_afetada[i]) subproblema.rotas.push_back(solucao.rotas[i]);
+        else intactas.rotas.push_back(solucao.rotas[i]);
+    }
+    if (!subproblema.rotas.empty()) {
+        subproblema.calcularCustoTotal();
+        buscaLocalVND(subproblema, grafo, capacidade_veiculo, melhorias_por_vizinhanca);
+        executarILS(subproblema, grafo, capacidade_veiculo, gen, melhorias_por_vizinhanca, Parametros::MAX_ITERACOES_ILS_WARM_START, 0);
+        intactas.rotas.insert(intactas.rotas.end(), subproblema.rotas.begin(), subproblema.rotas.end());
+    }
+    solucao.rotas = move(intactas.rotas);
+    solucao.calcularCustoTotal();
+}
+
+// Reotimiza a partir de uma solução exportada anteriormente: aplica VND e ILS somente sobre as rotas
+// afetadas pelas mudanças na instância, mantendo as demais intactas.
+bool reotimizarSolucaoAnterior(Solucao& solucao, const Instancia& instancia, const Grafo& grafo, mt19937& gen, vector<int>& melhorias_por_vizinhanca) {
+    string caminho = "solucoes/sol-" + instancia.nome_base + ".txt";
+    Solucao carregada; vector<bool> rota_afetada;
+    if (!carregarSolucaoAnterior(caminho, instancia, grafo, carregada, rota_afetada)) return false;
+
+    cout << "Warm start a partir de " << caminho << ": " << count(rota_afetada.begin(), rota_afetada.end(), true) << " de "
+         << carregada.rotas.size() << " rotas afetadas" << endl;
+
+    solucao = carregada;
+    reotimizarRotasAfetadas(solucao, rota_afetada, grafo, instancia.capacidade_veiculo, gen, melhorias_por_vizinhanca);
+    return true;
+}
+
+// Lê os lotes de alterações de um arquivo .alt: cada linha "origem destino novo_custo" muda o custo de
+// travessia de uma aresta/arco; linhas em branco separam os lotes e linhas iniciadas por '#' são ignoradas.
+// Linhas mal formadas são ignoradas com aviso (não encerram o lote).
+vector<vector<AlteracaoAresta>> lerLotesAlteracoes(const string& caminho) {
+    vector<vector<AlteracaoAresta>> lotes(1);
+    ifstream arq(caminho);
+    string linha;
+    int num_linha = 0;
+    while (getline(arq, linha)) {
+        num_linha++;
+        if (linha.rfind("#", 0) == 0) continue;
+        if (linha.find_first_not_of(" \t\r") == string::npos) {
+            if (!lotes.back().empty()) lotes.emplace_back();
+            continue;
+        }
+        stringstream ss(linha);
+        AlteracaoAresta alteracao; string resto;
+        if (ss >> alteracao.origem >> alteracao.destino >> alteracao.novo_custo && !(ss >> resto) && alteracao.novo_custo >= 0) {
+            lotes.back().push_back(alteracao);
         } else {
-            Rota nova_rota;
-            nova_rota.servicos.push_back(servico_a_inserir);
-            recalcularCustoERota(nova_rota, grafo);
-            solucao.rotas.push_back(nova_rota);
+            cerr << "Aviso: linha " << num_linha << " de " << caminho << " mal formada; ignorada: " << linha << endl;
         }
     }
-    
-    solucao.rotas.erase(remove_if(solucao.rotas.begin(), solucao.rotas.end(), [](const Rota& r){ return r.servicos.empty(); }), solucao.rotas.end());
+    if (lotes.back().empty()) lotes.pop_back();
+    return lotes;
+}
+
+// Aplica um lote de alterações à instância (arestas e custo dos serviços correspondentes) e atualiza os
+// menores caminhos de forma incremental. Devolve os pares de nós cuja distância mudou e acrescenta a
+// servicos_alterados os ids dos serviços cujo custo mudou.
+set<pair<int, int>> aplicarAlteracoesArestas(Instancia& instancia, Grafo& grafo, const vector<AlteracaoAresta>& lote, set<int>& servicos_alterados) {
+    // Mesma numeração de identificarServicos(): primeiro os nós, depois as arestas/arcos requeridos.
+    vector<int> servico_da_aresta(instancia.arestas.size(), -1);
+    int proximo_servico = count_if(instancia.nos.begin(), instancia.nos.end(), [](const auto& par) { return par.second.demanda > 0; });
+    for (size_t i = 0; i < instancia.arestas.size(); ++i) {
+        if (instancia.arestas[i].ehRequerida && instancia.arestas[i].demanda > 0) servico_da_aresta[i] = proximo_servico++;
+    }
+
+    set<pair<int, int>> arcos_alterados;
+    for (const auto& alteracao : lote) {
+        bool encontrada = false;
+        for (size_t i = 0; i < instancia.arestas.size(); ++i) {
+            Aresta& aresta = instancia.arestas[i];
+            bool mesmo_sentido = aresta.origem == alteracao.origem && aresta.destino == alteracao.destino;
+            bool sentido_oposto = !aresta.ehDirecionada && aresta.origem == alteracao.destino && aresta.destino == alteracao.origem;
+            if (!mesmo_sentido && !sentido_oposto) continue;
+            encontrada = true;
+            aresta.custo = alteracao.novo_custo;
+            arcos_alterados.insert({aresta.origem, aresta.destino});
+            if (!aresta.ehDirecionada) arcos_alterados.insert({aresta.destino, aresta.origem});
+            if (servico_da_aresta[i] != -1) {
+                ServicoRequerido& servico = instancia.servicos_requeridos[servico_da_aresta[i]];
+                servico.custo = alteracao.novo_custo;
+                servicos_alterados.insert(servico.id_servico);
+            }
+        }
+        if (!encontrada) {
+            cerr << "Aviso: aresta (" << alteracao.origem << ", " << alteracao.destino << ") inexistente; alteracao ignorada" << endl;
+        }
+    }
+
+    // Arestas paralelas: o custo do arco é o da mais barata entre as que o percorrem.
+    map<pair<int, int>, int> novos_custos;
+    for (const auto& arco : arcos_alterados) {
+        int custo = numeric_limits<int>::max();
+        for (const auto& aresta : instancia.arestas) {
+            bool percorre = (aresta.origem == arco.first && aresta.destino == arco.second) ||
+                            (!aresta.ehDirecionada && aresta.origem == arco.second && aresta.destino == arco.first);
+            if (percorre) custo = min(custo, aresta.custo);
+        }
+        novos_custos[arco] = custo;
+    }
+    return grafo.atualizarCustosArcos(novos_custos);
+}
+
+// Recalcula apenas as rotas que consultam algum par de distância alterado ou atendem um serviço cujo
+// custo mudou, marcando-as em rota_afetada. Devolve quantas rotas foram reavaliadas.
+int reavaliarRotasAfetadas(Solucao& solucao, const Instancia& instancia, const Grafo& grafo, const set<pair<int, int>>& pares_alterados,
+                           const set<int>& servicos_alterados, vector<bool>& rota_afetada) {
+    rota_afetada.resize(solucao.rotas.size(), false);
+    int reavaliadas = 0;
+    for (size_t r = 0; r < solucao.rotas.size(); ++r) {
+        Rota& rota = solucao.rotas[r];
+        if (rota.servicos.empty()) continue;
+        bool afetada = false;
+        int pos_atual = ID_DEPOSITO;
+        for (auto& servico : rota.servicos) {
+            if (pares_alterados.count({pos_atual, servico.no_origem})) afetada = true;
+            if (servicos_alterados.count(servico.id_servico)) {
+                servico.custo = instancia.servicos_requeridos[servico.id_servico - 1].custo;
+                afetada = true;
+            }
+            pos_atual = servico.no_destino;
+        }
+        if (pares_alterados.count({pos_atual, ID_DEPOSITO})) afetada = true;
+        if (!afetada) continue;
+        recalcularCustoERota(rota, grafo);
+        rota_afetada[r] = true;
+        reavaliadas++;
+    }
     solucao.calcularCustoTotal();
+    return reavaliadas;
+}
+
+// Aplica, lote a lote, as alterações de custo de <nome>.alt à instância já resolvida, sem refazer o
+// Floyd-Warshall, e ao final reotimiza as rotas afetadas. Devolve false se o arquivo não existir.
+bool aplicarArquivoAlteracoes(Instancia& instancia, Grafo& grafo, Solucao& solucao, mt19937& gen, vector<int>& melhorias_por_vizinhanca) {
+    string caminho = instancia.nome_base + ".alt";
+    if (!fs::exists(caminho)) return false;
+
+    vector<bool> rota_afetada;
+    vector<vector<AlteracaoAresta>> lotes = lerLotesAlteracoes(caminho);
+    for (size_t l = 0; l < lotes.size(); ++l) {
+        auto inicio = high_resolution_clock::now();
+        set<int> servicos_alterados;
+        set<pair<int, int>> pares_alterados = aplicarAlteracoesArestas(instancia, grafo, lotes[l], servicos_alterados);
+        int reavaliadas = reavaliarRotasAfetadas(solucao, instancia, grafo, pares_alterados, servicos_alterados, rota_afetada);
+        double tempo_ms = duration_cast<microseconds>(high_resolution_clock::now() - inicio).count() / 1000.0;
+        cout << "Lote " << l + 1 << " de " << caminho << ": " << lotes[l].size() << " arestas, " << pares_alterados.size()
+             << " distancias alteradas, " << reavaliadas << " rotas reavaliadas em " << tempo_ms << " ms (custo: "
+             << solucao.custo_total_geral << ")" << endl;
+
+#ifdef VERIFICAR_MENORES_CAMINHOS
+        // Teste: o resultado incremental deve coincidir com o recálculo completo.
+        auto inicio_completo = high_resolution_clock::now();
+        Grafo completo; completo.calcularMenoresCaminhos(instancia.arestas, instancia.nos);
+        double tempo_completo_ms = duration_cast<microseconds>(high_resolution_clock::now() - inicio_completo).count() / 1000.0;
+        assert(completo.distancias == grafo.distancias);
+        for (const auto& rota : solucao.rotas) {
+            Rota conferida = rota;
+            for (auto& servico : conferida.servicos) { servico.custo = instancia.servicos_requeridos[servico.id_servico - 1].custo; }
+            recalcularCustoERota(conferida, completo);
+            assert(conferida.custo_total == rota.custo_total);
+        }
+        cout << "  Conferido com o recalculo completo (" << tempo_completo_ms << " ms): distancias e custos das rotas coincidem" << endl;
+#endif
+    }
+    reotimizarRotasAfetadas(solucao, rota_afetada, grafo, instancia.capacidade_veiculo, gen, melhorias_por_vizinhanca);
+    return true;
 }
 
 // Orquestra todo o processo de resolução para uma única instância.
@@ -505,52 +1742,92 @@ void processarInstancia(const string& nomeArquivo) {
     cout << "\n==================================================" << endl;
     cout << "Processando instancia: " << nomeArquivo << endl;
     
+    unique_ptr<Perfilador> perfilador;
+    if (Parametros::MODO_PERFIL) { perfilador = make_unique<Perfilador>(); perfilador_ativo = perfilador.get(); }
+    
     auto inicio_total = high_resolution_clock::now();
     Instancia instancia(nomeArquivo);
     Grafo grafo; grafo.calcularMenoresCaminhos(instancia.arestas, instancia.nos);
+    LimiteInferior limite = calcularLimiteInferior(instancia, grafo);
+    if (limite.informativo) {
+        cout << "Limite inferior: " << limite.valor << " (servicos: " << limite.custo_servicos << ", deslocamento: "
+             << limite.deslocamento << ", veiculos >= " << limite.min_veiculos << ")" << endl;
+    } else {
+        cout << "Limite inferior: nao informativo (ha servico sem antecessor ou sucessor alcancavel no grafo)" << endl;
+    }
     auto inicio_solucao = high_resolution_clock::now();
     random_device rd; mt19937 gen(rd());
     vector<int> melhorias_por_vizinhanca(5, 0);
 
-    // 1. Construção da solução inicial
-    Solucao melhor_solucao_geral = construirSolucaoComSavings(instancia, grafo);
-    
-    // 2. Otimização inicial com busca local
-    buscaLocalVND(melhor_solucao_geral, grafo, instancia.capacidade_veiculo, melhorias_por_vizinhanca);
-    
-    Solucao solucao_base_para_perturbacao = melhor_solucao_geral;
-    int iter_sem_melhora = 0;
-    
-    // 3. Refinamento com Iterated Local Search
-    for (int i = 0; i < Parametros::MAX_ITERACOES_ILS && iter_sem_melhora < Parametros::MAX_ITER_SEM_MELHORA; ++i) {
-        Solucao solucao_de_trabalho = solucao_base_para_perturbacao;
-        
-        perturbarComLNS(solucao_de_trabalho, grafo, gen, instancia.capacidade_veiculo);
-        buscaLocalVND(solucao_de_trabalho, grafo, instancia.capacidade_veiculo, melhorias_por_vizinhanca);
+    // 0. Warm start: reaproveita a solução anterior, reotimizando apenas as rotas afetadas.
+    Solucao melhor_solucao_geral;
+    bool solucao_reaproveitada = Parametros::MODO_WARM_START &&
+        reotimizarSolucaoAnterior(melhor_solucao_geral, instancia, grafo, gen, melhorias_por_vizinhanca);
+    if (!solucao_reaproveitada) {
+        // 1. Construção da solução inicial
+        melhor_solucao_geral = construirSolucaoComSavings(instancia, grafo);
         
-        if (solucao_de_trabalho.custo_total_geral < melhor_solucao_geral.custo_total_geral) {
-            melhor_solucao_geral = solucao_de_trabalho;
-        }
+        // 2. Otimização inicial com busca local
+        buscaLocalVND(melhor_solucao_geral, grafo, instancia.capacidade_veiculo, melhorias_por_vizinhanca);
         
-        if (solucao_de_trabalho.custo_total_geral < solucao_base_para_perturbacao.custo_total_geral) {
-            solucao_base_para_perturbacao = solucao_de_trabalho;
-            iter_sem_melhora = 0;
+        // 3. Refinamento com Iterated Local Search (ou, em instâncias grandes, por decomposição em paralelo)
+        if (Parametros::MODO_DECOMPOSICAO && (int)instancia.servicos_requeridos.size() >= Parametros::MIN_SERVICOS_DECOMPOSICAO) {
+            int rodadas = executarDecomposicao(melhor_solucao_geral, grafo, instancia.capacidade_veiculo, gen, melhorias_por_vizinhanca, limite.valor);
+            cout << "Rodadas de decomposicao executadas: " << rodadas << endl;
         } else {
-            iter_sem_melhora++;
+            int iteracoes = executarILS(melhor_solucao_geral, grafo, instancia.capacidade_veiculo, gen, melhorias_por_vizinhanca, Parametros::MAX_ITERACOES_ILS, limite.valor);
+            cout << "Iteracoes ILS executadas: " << iteracoes << endl;
         }
     }
     
+    // 4. Alterações de custo das arestas: atualiza os menores caminhos de forma incremental e reotimiza as rotas afetadas.
+    if (Parametros::MODO_ALTERACOES && aplicarArquivoAlteracoes(instancia, grafo, melhor_solucao_geral, gen, melhorias_por_vizinhanca)) {
+        limite = calcularLimiteInferior(instancia, grafo);
+        if (limite.informativo) cout << "Limite inferior apos as alteracoes: " << limite.valor << endl;
+        else cout << "Limite inferior apos as alteracoes: nao informativo" << endl;
+    }
+    
     auto fim_solucao = high_resolution_clock::now();
     if (!validarSolucao(melhor_solucao_geral, instancia)) {
         // A função validarSolucao já imprime o erro específico no cerr.
     }
+    if (!limite.informativo) {
+        cout << "Gap em relacao ao limite inferior: indisponivel (limite nao informativo)" << endl;
+    } else if (usaTrechoInalcancavel(melhor_solucao_geral, grafo)) {
+        cout << "Gap em relacao ao limite inferior: indisponivel (a solucao usa um trecho sem caminho no grafo)" << endl;
+    } else {
+        cout << "Gap em relacao ao limite inferior: " << fixed << setprecision(2)
+             << 100.0 * calcularGap(melhor_solucao_geral.custo_total_geral, limite.valor) << "%" << defaultfloat << endl;
+    }
     long long tempo_total_ns = duration_cast<nanoseconds>(fim_solucao - inicio_total).count();
     long long tempo_solucao_ns = duration_cast<nanoseconds>(fim_solucao - inicio_solucao).count();
     melhor_solucao_geral.exportar(nomeArquivo, tempo_total_ns, tempo_solucao_ns, melhorias_por_vizinhanca);
+    
+    if (perfilador) { perfilador->imprimirRelatorio(); perfilador_ativo = nullptr; }
 }
 
 // Função principal que inicia o programa.
-int main() {
+// Opções: --warm-start reotimiza a partir das soluções já existentes em solucoes/;
+//         --perfil mede cada fase com contadores de hardware (Linux) ou apenas tempo;
+//         --decomposicao resolve instâncias grandes por subproblemas de rotas próximas, em paralelo;
+//         --threads=N fixa o número de threads da decomposição (padrão: uma por núcleo);
+//         --tolerancia-gap=X encerra o ILS quando o gap relativo ao limite inferior chega a X (ex: 0.01 = 1%);
+//         --alteracoes aplica, após resolver, as mudanças de custo das arestas listadas em <nome>.alt.
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        string opcao = argv[i];
+        if (opcao == "--warm-start") { Parametros::MODO_WARM_START = true; }
+        else if (opcao == "--perfil") { Parametros::MODO_PERFIL = true; }
+        else if (opcao == "--decomposicao") { Parametros::MODO_DECOMPOSICAO = true; }
+        else if (opcao.rfind("--threads=", 0) == 0) { Parametros::NUM_THREADS = atoi(opcao.c_str() + 10); }
+        else if (opcao.rfind("--tolerancia-gap=", 0) == 0) {
+            char* fim = nullptr;
+            Parametros::TOLERANCIA_GAP = strtod(opcao.c_str() + 17, &fim);
+            if (fim == opcao.c_str() + 17 || *fim != '\0' || Parametros::TOLERANCIA_GAP < 0) { cerr << "Tolerancia de gap invalida: " << opcao << endl; return 1; }
+        }
+        else if (opcao == "--alteracoes") { Parametros::MODO_ALTERACOES = true; }
+        else { cerr << "Opcao desconhecida: " << opcao << endl; return 1; }
+    }
     // Itera sobre todos os arquivos com extensão .dat na pasta atual.
     for (const auto& entry : fs::directory_iterator(".")) {
         if (entry.path().extension() == ".dat") {